@@ -0,0 +1,49 @@
+#ifndef EX3_ATOMICSNAPSHOT_HPP
+#define EX3_ATOMICSNAPSHOT_HPP
+
+#include <memory>
+#include <utility>
+
+
+/**
+ * this class reprasents the current version of an immutable object that is replaced as a whole, for
+ * example the matcher of a database that is reloaded while messages are scored against it.
+ * a reader takes the current version and keeps using it for as long as it holds it, even if a newer
+ * version is published in the meantime, and a version is freed when its last reader drops it.
+ * @tparam T the type of the object
+ */
+template <class T>
+class AtomicSnapshot
+{
+private:
+
+    /** the current version, only accessed through the atomic shared_ptr functions */
+    std::shared_ptr<const T> _current;
+
+public:
+
+    /**
+     * Construct a snapshot
+     * @param initial the first version, may be nullptr
+     */
+    explicit AtomicSnapshot(std::shared_ptr<const T> initial = nullptr) : _current(std::move(initial)) {}
+
+    AtomicSnapshot(const AtomicSnapshot&) = delete;
+
+    AtomicSnapshot& operator=(const AtomicSnapshot&) = delete;
+
+    /**
+     *
+     * @return the current version, it stays alive while the returned pointer is held
+     */
+    std::shared_ptr<const T> load() const { return std::atomic_load(&_current); }
+
+    /**
+     * replace the current version, the readers of the old version keep it until they drop it
+     * @param next the new version
+     */
+    void publish(std::shared_ptr<const T> next) { std::atomic_store(&_current, std::move(next)); }
+};
+
+
+#endif //EX3_ATOMICSNAPSHOT_HPP
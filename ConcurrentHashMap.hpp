@@ -0,0 +1,738 @@
+#ifndef EX3_CONCURRENTHASHMAP_HPP
+#define EX3_CONCURRENTHASHMAP_HPP
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "HashMap.hpp"
+
+#define CONCURRENT_SHARDS 64
+#define CONCURRENT_READ_SLOTS 64
+#define CONCURRENT_RECLAIM_BATCH 256
+
+
+/**
+ * this class reprasents a hash map that many threads can use at once, for read mostly workloads.
+ * readers take no lock at all: the buckets are chains of immutable nodes that a writer links and unlinks
+ * with single atomic stores, so a reader always sees a whole chain, the one before or the one after a
+ * change. a node or a bucket array that a writer removed is freed only after every reader that could
+ * still see it has left (a grace period, as in RCU).
+ * the keys are split over shards by the high bits of their hash, and every shard has its own write lock,
+ * its own bucket array and its own resize, so writers of different shards do not wait for each other and a
+ * resize copies one shard while the readers keep reading the old array of the shard.
+ * the lookups return copies of the values, since a node may be freed right after a reader leaves it.
+ * @tparam KeyT the type key of the hash map
+ * @tparam ValueT the type of the value in the hash map
+ * @tparam Hash the hash function of the keys, HashMapHash (default) or FastStringHash for strings
+ * @tparam KeyEqual the equality of the keys, == by default
+ */
+template <class KeyT, class ValueT, class Hash = HashMapHash<KeyT>, class KeyEqual = std::equal_to<>>
+class ConcurrentHashMap
+{
+public:
+
+    /** the type of the pairs in the hash map */
+    using value_type = std::pair<KeyT, ValueT>;
+
+private:
+
+    /**
+     * a pair of the map, never changed after it is linked, a new value is a new node
+     */
+    struct Node
+    {
+        value_type pair;
+        size_t hash;
+        std::atomic<Node*> next;
+
+        template <class... Args>
+        Node(size_t hash, Node* next, Args&&... args) : pair(std::forward<Args>(args)...), hash(hash), next(next)
+        {
+        }
+    };
+
+    /**
+     * the bucket array of a shard, it owns the nodes that are linked in it
+     */
+    struct Table
+    {
+        size_t mask;
+        std::unique_ptr<std::atomic<Node*>[]> buckets;
+
+        explicit Table(size_t capacity) : mask(capacity - 1), buckets(new std::atomic<Node*>[capacity])
+        {
+            for (size_t i = 0; i < capacity; i++)
+            {
+                buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * free the nodes of the table
+         */
+        void freeNodes()
+        {
+            for (size_t i = 0; i <= mask; i++)
+            {
+                Node* node = buckets[i].load(std::memory_order_relaxed);
+                while (node != nullptr)
+                {
+                    Node* next = node->next.load(std::memory_order_relaxed);
+                    delete node;
+                    node = next;
+                }
+            }
+        }
+    };
+
+    /**
+     * a shard of the map, on its own cache line
+     */
+    struct alignas(64) Shard
+    {
+        std::mutex writeLock;
+        std::atomic<Table*> table{nullptr};
+        int size = 0;
+    };
+
+    /**
+     * the readers that are inside a read section, counted per phase. a reader counts itself in the
+     * slot of its thread, so readers of different threads usually touch different cache lines
+     */
+    struct alignas(64) ReadSlot
+    {
+        std::atomic<int> readers[2];
+    };
+
+    /**
+     * a read section: the nodes and tables that the reader can see are not freed until it ends
+     */
+    class ReadGuard
+    {
+    private:
+
+        const ConcurrentHashMap* _map;
+        ReadSlot* _slot;
+        int _phase;
+
+    public:
+
+        explicit ReadGuard(const ConcurrentHashMap* map) : _map(map), _slot(&map->_slots[_slotIndex()])
+        {
+            // counted in the current phase only if the phase did not flip in between, so a writer that
+            // waits for a phase to drain never misses a reader of it
+            while (true)
+            {
+                _phase = _map->_phase.load();
+                _slot->readers[_phase].fetch_add(1);
+                if (_map->_phase.load() == _phase)
+                {
+                    return;
+                }
+                _slot->readers[_phase].fetch_sub(1);
+            }
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        ~ReadGuard() { _slot->readers[_phase].fetch_sub(1, std::memory_order_release); }
+    };
+
+    /** the shards */
+    std::unique_ptr<Shard[]> _shards;
+
+    /** the number of shards is 1 << _shardBits */
+    int _shardBits;
+
+    /** the read slots */
+    mutable ReadSlot _slots[CONCURRENT_READ_SLOTS];
+
+    /** the phase that new readers count themselves in */
+    mutable std::atomic<int> _phase;
+
+    /** serializes the grace periods */
+    std::mutex _graceLock;
+
+    /** guards the retired lists */
+    std::mutex _retireLock;
+
+    /** nodes that were unlinked and are freed after a grace period */
+    std::vector<Node*> _retiredNodes;
+
+    /** tables that were replaced and are freed with their nodes after a grace period */
+    std::vector<Table*> _retiredTables;
+
+    /** the number of pairs in the map */
+    std::atomic<int> _size;
+
+    /** the hash function we use to map the elemant*/
+    Hash _hash;
+
+    /** the equality we use to compare the keys*/
+    KeyEqual _keyEqual;
+
+    /**
+     *
+     * @return the read slot of the calling thread
+     */
+    static size_t _slotIndex()
+    {
+        static std::atomic<size_t> nextSlot{0};
+        thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % CONCURRENT_READ_SLOTS;
+        return slot;
+    }
+
+    /**
+     * @param key the key that we hash
+     * @return the hash of the key, mixed like in the HashMap
+     */
+    template <class K>
+    size_t _hashOf(const K& key) const
+    {
+        if constexpr (IsAvalanching<Hash>::value)
+        {
+            return _hash(key);
+        }
+        else
+        {
+            return hashIndexMix(_hash(key));
+        }
+    }
+
+    /**
+     * @param hash the hash of a key
+     * @return the shard of the key, by the high bits of the hash (the low bits pick the bucket)
+     */
+    Shard& _shardOf(size_t hash) const
+    {
+        return _shards[_shardBits == 0 ? 0 : hash >> (sizeof(size_t) * 8 - _shardBits)];
+    }
+
+    /**
+     * find a node, the caller is inside a read section or holds the write lock of the shard
+     * @param table the table of the shard
+     * @param hash the hash of the key
+     * @param key the key that we look for
+     * @return the node of the key, nullptr if the key is not there
+     */
+    template <class K>
+    Node* _findNode(const Table* table, size_t hash, const K& key) const
+    {
+        Node* node = table->buckets[hash & table->mask].load(std::memory_order_acquire);
+        for (; node != nullptr; node = node->next.load(std::memory_order_acquire))
+        {
+            if (node->hash == hash && _keyEqual(node->pair.first, key))
+            {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * unlink a node from its bucket, the caller holds the write lock of the shard
+     * @param table the table of the shard
+     * @param node the node
+     * @param replacement the node that takes its place in the chain, nullptr to just remove it
+     */
+    void _unlink(Table* table, Node* node, Node* replacement);
+
+    /**
+     * move a shard to a table of another capacity, the caller holds the write lock of the shard.
+     * the nodes are copied into the new table, since the readers of the old table still walk the old
+     * chains, and the old table is retired
+     * @param shard the shard
+     * @param capacity the number of buckets of the new table, a power of 2
+     */
+    void _resize(Shard& shard, size_t capacity);
+
+    /**
+     * grow or shrink a shard by the load factors of the HashMap, the caller holds the write lock of the shard
+     * @param shard the shard
+     */
+    void _fitLoad(Shard& shard)
+    {
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        size_t capacity = table->mask + 1;
+        if (shard.size > capacity * UPPER_BOUND)
+        {
+            _resize(shard, capacity * 2);
+        }
+        else if (capacity > 1 && shard.size < capacity * LOWER_BOUND)
+        {
+            _resize(shard, capacity / 2);
+        }
+    }
+
+    /**
+     * retire a node or a table, it is freed by _reclaim after a grace period. a writer retires under the
+     * write lock of its shard, and calls _reclaim after it releases the lock
+     * @param node a node to retire, or nullptr
+     * @param table a table to retire, or nullptr
+     */
+    void _retire(Node* node, Table* table);
+
+    /**
+     * free the retired nodes and tables if there are enough of them, the caller holds no write lock
+     */
+    void _reclaimIfFull()
+    {
+        bool full;
+        {
+            std::lock_guard<std::mutex> guard(_retireLock);
+            full = _retiredNodes.size() + _retiredTables.size() >= CONCURRENT_RECLAIM_BATCH;
+        }
+        if (full)
+        {
+            _reclaim();
+        }
+    }
+
+    /**
+     * wait until every reader that was inside a read section when it was called has left
+     */
+    void _waitForReaders();
+
+    /**
+     * free everything that was retired before the call, after a grace period
+     */
+    void _reclaim();
+
+    /**
+     * insert a pair, the key is constructed only if it is not in the map yet
+     * @param assign true to replace the value of an existing key
+     * @param key the key
+     * @param value the value
+     * @return true if the key was not in the map
+     */
+    template <class K, class V>
+    bool _put(bool assign, K&& key, V&& value);
+
+    /**
+     * find the value of a key, in a single read section
+     * @param key the key that we look for
+     * @param value gets a copy of the value of the key, may be nullptr
+     * @return true if the key is in the map
+     */
+    template <class K>
+    bool _get(const K& key, ValueT* value) const
+    {
+        ReadGuard guard(this);
+        size_t hash = _hashOf(key);
+        Node* node = _findNode(_shardOf(hash).table.load(std::memory_order_acquire), hash, key);
+        if (node == nullptr)
+        {
+            return false;
+        }
+        if (value != nullptr)
+        {
+            *value = node->pair.second;
+        }
+        return true;
+    }
+
+    /**
+     * @param key the key that we look for
+     * @return a copy of the value of the key
+     * @throw HashMapInvalidKeyException if the key is not in the map
+     */
+    template <class K>
+    ValueT _at(const K& key) const
+    {
+        ValueT value;
+        if (!_get(key, &value))
+        {
+            throw HashMapInvalidKeyException();
+        }
+        return value;
+    }
+
+    /**
+     * erase a key
+     * @param key the key
+     * @return true if the key was erased
+     */
+    template <class K>
+    bool _erase(const K& key);
+
+public:
+
+    /**
+     * Construct an empty map
+     * @param shards the number of shards, rounded up to a power of 2, more shards let more writers work at once
+     */
+    explicit ConcurrentHashMap(int shards = CONCURRENT_SHARDS);
+
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    /**
+     * destroy the map, no thread may use it anymore
+     */
+    ~ConcurrentHashMap();
+
+    /**
+     *
+     * @return the number of pairs in the map, it may change right after the call
+     */
+    int size() const { return _size.load(std::memory_order_relaxed); }
+
+    /**
+     *
+     * @return true if the map is empty
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * insert a pair, if the key is already in the map it keeps its value
+     * @param key the key
+     * @param value the value
+     * @return true if the pair was inserted, false if the key was already in the map
+     */
+    bool insert(const KeyT& key, const ValueT& value) { return _put(false, key, value); }
+
+    /**
+     * insert a pair, moving the key and the value in
+     * @param key the key
+     * @param value the value
+     * @return true if the pair was inserted, false if the key was already in the map
+     */
+    bool insert(KeyT&& key, ValueT&& value) { return _put(false, std::move(key), std::move(value)); }
+
+    /**
+     * insert a pair, or replace the value of a key that is already in the map
+     * @param key the key
+     * @param value the value
+     * @return true if the key was inserted, false if its value was replaced
+     */
+    template <class V>
+    bool insert_or_assign(const KeyT& key, V&& value) { return _put(true, key, std::forward<V>(value)); }
+
+    /**
+     * checks if hash map contains a certion key
+     * @param key the key that we check if is containing
+     * @return true if so false otherwise
+     */
+    bool containsKey(const KeyT& key) const { return _get(key, nullptr); }
+
+    /**
+     * checks if hash map contains a certion key, without making a KeyT from it. the overloads that take
+     * a K exist only when the hash function and the key equality are transparent, as in the HashMap
+     * @param key the key that we check if is containing, for example a std::string_view
+     * @return true if so false otherwise
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = IsTransparent<H, E>>
+    bool containsKey(const K& key) const { return _get(key, nullptr); }
+
+    /**
+     *
+     * @param key the key that we look for is value
+     * @return a copy of the value of the key, a reference could outlive the pair
+     * @throw HashMapInvalidKeyException if the key is not in the map
+     */
+    ValueT at(const KeyT& key) const { return _at(key); }
+
+    /**
+     *
+     * @param key the key that we look for is value, for example a std::string_view
+     * @return a copy of the value of the key
+     * @throw HashMapInvalidKeyException if the key is not in the map
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = IsTransparent<H, E>>
+    ValueT at(const K& key) const { return _at(key); }
+
+    /**
+     * find the value of a key in one lookup, unlike containsKey and then at that another thread can
+     * erase the key in between
+     * @param key the key that we look for is value
+     * @param value gets a copy of the value of the key
+     * @return true if the key is in the map, false otherwise
+     */
+    bool find(const KeyT& key, ValueT* value) const { return _get(key, value); }
+
+    /**
+     * find the value of a key in one lookup
+     * @param key the key that we look for is value, for example a std::string_view
+     * @param value gets a copy of the value of the key
+     * @return true if the key is in the map, false otherwise
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = IsTransparent<H, E>>
+    bool find(const K& key, ValueT* value) const { return _get(key, value); }
+
+    /**
+     * we erase a key from the hash map
+     * @param key the key that we want to erase
+     * @return true if we erase, false otherwise.
+     */
+    bool erase(const KeyT& key) { return _erase(key); }
+
+    /**
+     * we erase a key from the hash map
+     * @param key the key that we want to erase, for example a std::string_view
+     * @return true if we erase, false otherwise.
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = IsTransparent<H, E>>
+    bool erase(const K& key) { return _erase(key); }
+
+    /**
+     * erase all the pairs, shard by shard
+     */
+    void clear();
+
+    /**
+     * call a function on every pair, shard after shard, inside a read section. every shard is seen as it
+     * was at one moment, but the shards are not seen at the same moment
+     * @param visit called with every const value_type&, it may not change the map
+     */
+    template <class Visit>
+    void forEach(Visit visit) const;
+
+    /**
+     *
+     * @return a copy of all the pairs, taken like forEach
+     */
+    std::vector<value_type> snapshot() const
+    {
+        std::vector<value_type> pairs;
+        pairs.reserve((size_t) size());
+        forEach([&pairs](const value_type& pair) { pairs.push_back(pair); });
+        return pairs;
+    }
+};
+
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::ConcurrentHashMap(int shards) : _shardBits(0), _phase(0), _size(0)
+{
+    while ((1 << _shardBits) < shards)
+    {
+        _shardBits++;
+    }
+    _shards.reset(new Shard[(size_t) 1 << _shardBits]);
+    for (size_t i = 0; i < ((size_t) 1 << _shardBits); i++)
+    {
+        _shards[i].table.store(new Table(1), std::memory_order_relaxed);
+    }
+    for (auto& slot : _slots)
+    {
+        slot.readers[0].store(0);
+        slot.readers[1].store(0);
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::~ConcurrentHashMap()
+{
+    for (size_t i = 0; i < ((size_t) 1 << _shardBits); i++)
+    {
+        Table* table = _shards[i].table.load(std::memory_order_relaxed);
+        table->freeNodes();
+        delete table;
+    }
+    for (Node* node : _retiredNodes)
+    {
+        delete node;
+    }
+    for (Table* table : _retiredTables)
+    {
+        table->freeNodes();
+        delete table;
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+void ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::_unlink(Table* table, Node* node, Node* replacement)
+{
+    std::atomic<Node*>* link = &table->buckets[node->hash & table->mask];
+    while (link->load(std::memory_order_relaxed) != node)
+    {
+        link = &link->load(std::memory_order_relaxed)->next;
+    }
+    if (replacement == nullptr)
+    {
+        replacement = node->next.load(std::memory_order_relaxed);
+    }
+    link->store(replacement, std::memory_order_release);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+void ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::_resize(Shard& shard, size_t capacity)
+{
+    Table* old = shard.table.load(std::memory_order_relaxed);
+    Table* table = new Table(capacity);
+    for (size_t i = 0; i <= old->mask; i++)
+    {
+        Node* node = old->buckets[i].load(std::memory_order_relaxed);
+        for (; node != nullptr; node = node->next.load(std::memory_order_relaxed))
+        {
+            std::atomic<Node*>& bucket = table->buckets[node->hash & table->mask];
+            bucket.store(new Node(node->hash, bucket.load(std::memory_order_relaxed), node->pair),
+                         std::memory_order_relaxed);
+        }
+    }
+    shard.table.store(table, std::memory_order_release);
+    _retire(nullptr, old);
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+void ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::_retire(Node* node, Table* table)
+{
+    std::lock_guard<std::mutex> guard(_retireLock);
+    if (node != nullptr)
+    {
+        _retiredNodes.push_back(node);
+    }
+    if (table != nullptr)
+    {
+        _retiredTables.push_back(table);
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+void ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::_waitForReaders()
+{
+    std::lock_guard<std::mutex> guard(_graceLock);
+    int old = _phase.load();
+    _phase.store(1 - old);
+    for (auto& slot : _slots)
+    {
+        // seq_cst like the store of the phase: the reader adds itself and then reads the phase, we store the
+        // phase and then read the count, so one of us must see the other, an acquire load may read a stale 0
+        while (slot.readers[old].load() != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+void ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::_reclaim()
+{
+    std::vector<Node*> nodes;
+    std::vector<Table*> tables;
+    {
+        std::lock_guard<std::mutex> guard(_retireLock);
+        nodes.swap(_retiredNodes);
+        tables.swap(_retiredTables);
+    }
+    if (nodes.empty() && tables.empty())
+    {
+        return;
+    }
+    _waitForReaders();
+    for (Node* node : nodes)
+    {
+        delete node;
+    }
+    for (Table* table : tables)
+    {
+        table->freeNodes();
+        delete table;
+    }
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+template <class K, class V>
+bool ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::_put(bool assign, K&& key, V&& value)
+{
+    size_t hash = _hashOf(key);
+    Shard& shard = _shardOf(hash);
+    bool inserted = false;
+    {
+        std::lock_guard<std::mutex> guard(shard.writeLock);
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        Node* found = _findNode(table, hash, key);
+        if (found != nullptr && !assign)
+        {
+            return false;
+        }
+        if (found != nullptr)
+        {
+            // the readers of the old node still see its old value, the new value is a new node in its place
+            _unlink(table, found, new Node(hash, found->next.load(std::memory_order_relaxed), found->pair.first,
+                                           std::forward<V>(value)));
+            _retire(found, nullptr);
+        }
+        else
+        {
+            std::atomic<Node*>& bucket = table->buckets[hash & table->mask];
+            bucket.store(new Node(hash, bucket.load(std::memory_order_relaxed), std::forward<K>(key),
+                                  std::forward<V>(value)), std::memory_order_release);
+            shard.size++;
+            _size.fetch_add(1, std::memory_order_relaxed);
+            _fitLoad(shard);
+            inserted = true;
+        }
+    }
+    _reclaimIfFull();
+    return inserted;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+template <class K>
+bool ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::_erase(const K& key)
+{
+    size_t hash = _hashOf(key);
+    Shard& shard = _shardOf(hash);
+    {
+        std::lock_guard<std::mutex> guard(shard.writeLock);
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        Node* found = _findNode(table, hash, key);
+        if (found == nullptr)
+        {
+            return false;
+        }
+        _unlink(table, found, nullptr);
+        _retire(found, nullptr);
+        shard.size--;
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        _fitLoad(shard);
+    }
+    _reclaimIfFull();
+    return true;
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+void ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::clear()
+{
+    for (size_t i = 0; i < ((size_t) 1 << _shardBits); i++)
+    {
+        Shard& shard = _shards[i];
+        std::lock_guard<std::mutex> guard(shard.writeLock);
+        _retire(nullptr, shard.table.exchange(new Table(1), std::memory_order_acq_rel));
+        _size.fetch_sub(shard.size, std::memory_order_relaxed);
+        shard.size = 0;
+    }
+    _reclaim();
+}
+
+template <class KeyT, class ValueT, class Hash, class KeyEqual>
+template <class Visit>
+void ConcurrentHashMap<KeyT, ValueT, Hash, KeyEqual>::forEach(Visit visit) const
+{
+    ReadGuard guard(this);
+    for (size_t i = 0; i < ((size_t) 1 << _shardBits); i++)
+    {
+        const Table* table = _shards[i].table.load(std::memory_order_acquire);
+        for (size_t bucket = 0; bucket <= table->mask; bucket++)
+        {
+            Node* node = table->buckets[bucket].load(std::memory_order_acquire);
+            for (; node != nullptr; node = node->next.load(std::memory_order_acquire))
+            {
+                visit((const value_type&) node->pair);
+            }
+        }
+    }
+}
+
+
+#endif //EX3_CONCURRENTHASHMAP_HPP
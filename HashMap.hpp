@@ -1,823 +1,1669 @@
-//
-// Created by gueta on 13/09/2019.
-//
-
-#ifndef EX3_HASHMAP_HPP
-#define EX3_HASHMAP_HPP
-
-#include <iostream>
-#include <vector>
-#include <cassert>
-#include <memory>
-#include <algorithm>
-
-
-#define CAPACITY 16
-#define SIZE 0
-#define LOWER_BOUND 0.25
-#define UPPER_BOUND 0.75
-#define HASHMAP_CTOR_INVALID_MSG "HashMap Constructor Invalid Input"
-#define HASHMAP_KEY_NOT_FOUND_MSG "HashMap at Invalid Input: key not found"
-
-
-
-/// ###### exceptions #######
-/**
- * the InvalidInputException is an abstract class represents an invalid
- */
-class InvalidInputException: public std::exception
-{
-public:
-    /**
-    * @return the error msg to std cerr in case of this error
-    */
-    virtual const char* what() const noexcept override = 0;
-};
-
-/**
- * the HashMapInvalidInputException is an abstract class represents an invalid input to the HashMap
- * class
- */
-class HashMapInvalidInputException : public InvalidInputException
-{
-    /**
-    * @return the error msg to std cerr in case of this error
-    */
-    virtual const char* what() const noexcept override = 0;
-
-};
-
-/**
- * the HashMapInvalidInputConstructorException class represents an invalid input to the HashMap
- * Constructor
- */
-class HashMapInvalidInputConstructorException : public HashMapInvalidInputException
-{
-    /**
-    * @return the error msg to std cerr in case of this error
-    */
-    inline const char* what() const noexcept override { return HASHMAP_CTOR_INVALID_MSG; }
-};
-
-/**
- * the HashMapInvalidInputKeyException class represents an invalid input to the HashMap
- * functions that require to find a key and it does not exist
- */
-class HashMapInvalidKeyException : public HashMapInvalidInputException
-{
-    /**
-    * @return the error msg to std cerr in case of this error
-    */
-    inline const char* what() const noexcept override { return HASHMAP_KEY_NOT_FOUND_MSG; }
-};
-
-
-
-/// ### end of exceptions ###///
-
-
-
-
-
-/**
- * this class reprasents hash map
- * @tparam KeyT the type key of the hash map
- * @tparam ValueT the type of the value in the hash map
- */
-template <class KeyT, class ValueT>
-class HashMap
-{
-    // it was said its ok to use typename to decribe a bucket
-    using Bucket  = typename std::vector<std::pair<KeyT, ValueT>>;
-
-private:
-
-    /** the hash map lower load factor*/
-    double _lowerLoadFactor;
-
-     /** the hash map upper load factor*/
-     double _upperLoadFactor;
-
-     /** number of buckets in the vecOfVectors*/
-     double _capacity;
-
-
-    /** numbet of pairs in the hash map*/
-    int _size;
-
-
-    /** the load factor of the hash map */
-    double _loadFactor;
-
-    /** the hash function we use to map the elemant*/
-    std :: hash<KeyT> _hash;
-
-    /** vetor of buckets , represents the hash table*/
-    std::vector<Bucket> _bucketsVec;
-
-    /**
-     *
-     * @param key the key that we check if in the bucket
-     * @param bucket the bucket that we check if the key is there
-     * @return true if so false otherwise
-     */
-    bool _bucketContainKey(const KeyT &key, Bucket bucket) const;
-
-    /**
-     * insert a pait in the bucket
-     * @param key the key that we add to the pair bucket
-     * @param value the value the pair in the bucket
-     */
-    void _addToBucketVec(const KeyT &key, const ValueT& value);
-
-    /**
-     * erase a pair from the bucet by the key
-     * @param key the key that we erase
-     */
-    void _eraseFromBucketVec(const KeyT &key);
-
-    /**
-     * find the index of the key in the bucket vec
-     * @param key the key that we look for
-     * @return  index of the key in the bucket vec
-     */
-    int _findIndex(const KeyT key) const;
-
-    /**
-     * re size the capacity of the hash map acoording to the bool given
-     * @param inLarge if true we inlarge the table , if false we shrink.
-     */
-    void _reSize(const bool inLarge);
-
-    /**
-     * this is an help funck to the vector const, its insertingg the pairs from the vectors to the hash map
-     * @param key the key that we insert
-     * @param value the value we insert
-     */
-    void _vectorInsert(const KeyT& key, const ValueT& value);
-
-
-
-
-
-public:
-
-    /**
-     *
-     * @param lowerLoadFactor lowerLoadFactor of the table
-     * @param upperLoadFactor upperLoadFactor of the table
-     */
-    HashMap(double lowerLoadFactor, double upperLoadFactor): _lowerLoadFactor(lowerLoadFactor),
-                                                              _upperLoadFactor(upperLoadFactor),
-                                                              _capacity(CAPACITY),
-                                                              _size(SIZE), _loadFactor(0.0)
-
-    {
-        if (lowerLoadFactor >= upperLoadFactor)
-        {
-            throw HashMapInvalidInputConstructorException();
-        }
-        if (lowerLoadFactor > 1 || upperLoadFactor > 1 ||
-            lowerLoadFactor < 0  || upperLoadFactor < 0)
-        {
-            throw HashMapInvalidInputConstructorException();
-        }
-        _bucketsVec.resize(CAPACITY);
-    };
-
-    /**
-     * efault constructor sets the lower factor to 0.25 and upper factor to 0.75
-     */
-    HashMap(): HashMap(LOWER_BOUND, UPPER_BOUND){};
-
-    /**
-     * Receiving two vectors of keys and values, this constructor sets the map through that
-     * @param keyVector vector of keys.
-     * @param valuesVector vector of values.
-     */
-    HashMap(std::vector<KeyT> keyVector, std::vector<ValueT> valuesVector):
-            HashMap(LOWER_BOUND, UPPER_BOUND)
-    {
-        if (keyVector.size() != valuesVector.size())
-        {
-            throw HashMapInvalidInputConstructorException();
-        }
-        for (int i = 0; i < keyVector.size(); i++)
-        {
-            _vectorInsert(keyVector.at(i), valuesVector.at(i));
-        }
-    }
-
-    /**
-     * copy constructor
-     * @param other the other HashMap that been copied
-     */
-    HashMap(HashMap &  other) = default;
-
-    /**
-     * copy move constructor
-     * @param other other the other HashMap that been copied
-     */
-    HashMap(HashMap &&  other) = default;
-
-    /**
-     * distructor
-     */
-    ~HashMap() = default;
-
-    /**
-     *
-     * @return  _capacity
-     */
-    int capacity() const{ return _capacity; }
-
-    /**
-     *
-     * @return _size/
-     */
-    int size() const { return _size; }
-
-    /**
-     *
-     * @return _loadFactor
-     */
-    double getLoadFactor() const {return _loadFactor; }
-
-    /**
-     *
-     * @return true if the hash Map is empty false otherwise.
-     */
-    bool empty() const { return  (_size == 0); }
-
-    /**
-     * insert a pair the to hash map
-     * @param key the key that we insert
-     * @param value the value that we insert
-     * @return true if the insertion was sueccsid false oherwise
-     */
-    bool insert(const KeyT& key, const ValueT& value);
-
-    /**
-     * checks if hash map contains a certion key
-     * @param key the key that we check if is containing
-     * @return true if so false otherwise
-     */
-    bool containsKey(const KeyT& key) const ;
-
-    /**
-     *
-     * @param key the key that we look for is value
-     * @return the value of the key in the hash map
-     */
-    const ValueT& at(const KeyT& key) const;
-
-    /**
-    *
-    * @param key the key that we look for is value
-    * @return the value of the key in the hash map
-    */
-    ValueT& at(const KeyT& key);
-
-
-    /**
-     *
-     * @param keyToFindBucket the key that we want his bucket
-     * @return the size of the bucket fo the key we want
-     */
-    int bucketSize (const KeyT& keyToFindBucket) const;
-
-    /**
-     * overloading the operator !=
-     * @param other the other we doing the != with
-     * @return true if this != other , false otherwise
-     */
-    inline bool operator!=(const HashMap<KeyT, ValueT>& other) const { return !(*this == other); }
-
-    /**
-     * overloading the operator =
-     * @param other the other that we asiigen this to
-     * @return this
-     */
-    HashMap<KeyT, ValueT>& operator=(const HashMap<KeyT, ValueT>& other) = default;
-
-    /**
-     * we erase a key from the hash map
-     * @param key the key that we want to erase
-     * @return true if we erase, false otherwise.
-     */
-    bool erase(const KeyT& key);
-
-    /**
-     * clear all the hash map/
-     */
-    void clear();
-
-    /**
-     * default move assignment
-     * @param other other to assign to
-     * @return the assigned member
-     */
-    HashMap<KeyT, ValueT>& operator=(HashMap<KeyT, ValueT> && other) noexcept = default;
-    /**
-     * the function return the begin of the hash map iterator
-     * @return iterator object, points to the begin
-     */
-
-    /**
-     * overloading the operator []
-     * @param key the key that we want is value
-     * @return the value of the key in the hash map
-     */
-    ValueT& operator[](const KeyT& key);
-
-    /**
-     * overloading the operator []
-     * @param key the key that we want is value
-     * @return the value of the key in the hash map
-     */
-    const ValueT& operator[](const KeyT& key) const;
-
-    /**
-     * overloading the operator []
-     * @param other the other hash map that we compering to
-     * @return true if this == other , false other wise.
-     */
-    bool operator==(const HashMap<KeyT, ValueT>& other) const;
-
-    /**
-     * Class that enables iterating over the map, where it stays constant
-     */
-    class const_iterator
-    {
-
-    private:
-
-        /** pointer to the hash msp*/
-        const HashMap *_map;
-
-        /** 2 indexes that indecates on the loocation in the hash map*/
-        int _bucketIndex, _vectorIndex;
-
-    public:
-
-        /**
-         * Constructor of the iterator, sets the iteration to the first one
-         * @param map pointer of hashmap
-         * @param bucketIndex has default value of 0
-         * @param vectorIndex has default value of 0
-         */
-        explicit const_iterator(const HashMap * map, int bucketIndex = 0, int vectorIndex = 0)
-                : _map(map), _bucketIndex(bucketIndex), _vectorIndex(vectorIndex)
-        {
-            if(!_map->empty())
-            {
-
-                while ( _bucketIndex != _map->_capacity && _map->_bucketsVec.at(_bucketIndex).empty() )
-                {
-                    _bucketIndex++;
-                }
-            }
-        }
-
-        /**
-         * overloading the operator ++this
-         * @return this
-         */
-        const const_iterator& operator++()
-        {
-            if(_bucketIndex == _map->_capacity)
-            {
-                return *this;
-            }
-            if((int)_map->_bucketsVec.at(_bucketIndex).size() - 1 == _vectorIndex)
-            {
-                _bucketIndex ++ ;
-                _vectorIndex = 0;
-                while ( _map->_capacity != _bucketIndex && _map->_bucketsVec.at(_bucketIndex).empty())
-                {
-                    _bucketIndex ++;
-                }
-                return *this;
-            }
-            else
-            {
-                _vectorIndex ++;
-            }
-            return *this;
-        }
-
-        /**
-         * overloading the operator this++
-         * @return this
-         */
-        const HashMap::const_iterator operator++(int)
-        {
-            const_iterator temp = *this;
-            ++(*this);
-            return temp;
-        }
-
-        /**
-         * overloading the operator *
-         * @return the pair that in that index
-         */
-        const std :: pair<KeyT, ValueT> &operator*()const;
-
-        /**
-         * overloading the operator ->
-         * @return the pointer to the pair that in that index
-         */
-        const std :: pair<KeyT, ValueT> *operator->()const;
-
-        /**
-         * overloading the operator ==
-         * @param other the other hash map we == with
-         * @return true if this == other ' false otherwise
-         */
-        bool operator==(const_iterator const &other) const;
-
-        /**
-         * overloading the operator !=
-         * @param other the other hash map we == with
-         * @return true if this != other ' false otherwise
-         */
-        inline bool operator!=(const const_iterator other) const{ return !(*this == other); }
-    };
-
-    /**
-     * First iterator of the hash map
-     * @return the iterator of the beginning of the map
-     */
-    inline const_iterator begin() const{ return const_iterator(this); }
-
-    /**
-     * last iterator of the hash map
-     * @return he iterator of the end of the map
-     */
-    inline const_iterator end() const{ return const_iterator(this, _capacity, 0); }
-
-    /**
-    * First iterator of the hash map
-    * @return the iterator of the beginning of the map
-    */
-    inline const_iterator cbegin() const{ return const_iterator(this); }
-
-    /**
-    * First iterator of the hash map
-    * @return the iterator of the beginning of the map
-    */
-    inline const_iterator cend() const{ return const_iterator(this, _capacity, 0); }
-
-
-
-};
-
-
-
-/**
-* overloading the operator *
-* @return the pair that in that index
-*/
-template<class KeyT, class ValueT>
-const std::pair<KeyT, ValueT> &HashMap<KeyT, ValueT>::const_iterator::operator*() const
-{
-    return _map->_bucketsVec.at(_bucketIndex).at(_vectorIndex);
-}
-
-/**
-* overloading the operator ->
-* @return the pointer to the pair that in that index
-*/
-template<class KeyT, class ValueT>
-const std::pair<KeyT, ValueT> *HashMap<KeyT, ValueT>::const_iterator::operator->() const
-{
-    return &(_map->_bucketsVec.at(_bucketIndex).at(_vectorIndex));
-}
-
-/**
-* overloading the operator ==
-@param other the other hash map we == with
-* @return true if this != other ' false otherwise
-*/
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::const_iterator::operator==(const const_iterator &other) const
-{
-    return (_map == other._map && _vectorIndex == other._vectorIndex &&
-            _bucketIndex == other._bucketIndex );
-}
-
-/**
-* insert a pair the to hash map
-* @param key the key that we insert
-* @param value the value that we insert
-* @return true if the insertion was sueccsid false oherwise
-*/
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::insert(const KeyT &key, const ValueT &value)
-{
-    if(containsKey(key))
-    {
-        return false;
-    }
-    _addToBucketVec(key, value);
-    _size ++;
-    _loadFactor = (double) _size / _capacity;
-    if (_loadFactor > _upperLoadFactor)
-    {
-        this->_reSize(true);
-    }
-    return true;
-}
-
-/**
-* find the index of the key in the bucket vec
-* @param key the key that we look for
-* @return  index of the key in the bucket vec
-*/
-template<class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::_findIndex(const KeyT key) const
-{
-    return (int)_hash(key) & (int)(_capacity - 1);
-}
-
-
-/**
- * insert a pait in the bucket
- * @param key the key that we add to the pair bucket
- * @param value the value the pair in the bucket
- */
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::containsKey(const KeyT& key) const
-{
-   int index = _findIndex(key);
-   Bucket bucketToCheck = _bucketsVec.at(index);
-   return _bucketContainKey(key, bucketToCheck);
-}
-
-/**
-* checks if hash map contains a certion key
-* @param key the key that we check if is containing
-* @return true if so false otherwise
-*/
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::_bucketContainKey(const KeyT &key, Bucket bucket) const
-{
-    for(int i = 0 ; i < (int)bucket.size(); i ++)
-    {
-        if(bucket.at(i).first == key)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-
-
-/**
- * insert a pait in the bucket
- * @param key the key that we add to the pair bucket
- * @param value the value the pair in the bucket
- */
-template<class Key, class ValueT>
-void HashMap<Key, ValueT>::_addToBucketVec(const Key &key, const ValueT& value)
-{
-    int index = _findIndex(key);
-    Bucket& bucketToAdd = _bucketsVec.at(index);
-    std :: pair<Key, ValueT> pairToAdd(key, value);
-    bucketToAdd.push_back(pairToAdd);
-}
-
-
-/**
- * re size the capacity of the hash map acoording to the bool given
- * @param inLarge if true we inlarge the table , if false we shrink.
- */
-template<class KeyT, class ValueT>
-void HashMap<KeyT, ValueT>::_reSize(const bool inLarge)
-{
-    int newCap = inLarge ? _capacity * 2 : _capacity / 2;
-    HashMap<KeyT, ValueT> newHashTable;
-    newHashTable._upperLoadFactor = _upperLoadFactor;
-    newHashTable._lowerLoadFactor = _lowerLoadFactor;
-    newHashTable._capacity = newCap;
-    newHashTable._bucketsVec.resize((unsigned long)newCap);
-    for (auto& vec: _bucketsVec)
-    {
-        for (auto& pair : vec)
-        {
-            newHashTable.insert(pair.first, pair.second);
-        }
-    }
-    *this = newHashTable;
-}
-
-/**
-*
-* @param key the key that we look for is value
-* @return the value of the key in the hash map
-*/
-template<class KeyT, class ValueT>
-const ValueT &HashMap<KeyT, ValueT>::at(const KeyT &key) const
-{
-    if(!containsKey(key))
-    {
-        throw HashMapInvalidKeyException();
-    }
-    int index = _findIndex(key);
-    Bucket bucketToCheck = _bucketsVec.at(index);
-    for(int i = 0 ; i < bucketToCheck.size(); i ++)
-    {
-        if(bucketToCheck.at(i).first == key)
-        {
-            ValueT& second = bucketToCheck.at(i).second;
-            return second;
-        }
-    }
-
-}
-
-
-
-/**
-*
-* @param key the key that we look for is value
-* @return the value of the key in the hash map
-*/
-template<class KeyT, class ValueT>
-ValueT &HashMap<KeyT, ValueT>::at(const KeyT &key)
-{
-    if(!containsKey(key))
-    {
-        throw HashMapInvalidKeyException();
-    }
-    int index = _findIndex(key);
-    Bucket bucketToCheck = _bucketsVec.at(index);
-    for(int i = 0 ; i < bucketToCheck.size(); i ++)
-    {
-        if(bucketToCheck.at(i).first == key)
-        {
-            return _bucketsVec.at(index).at(i).second;
-        }
-    }
-}
-
-
-/**
-*
-* @param keyToFindBucket the key that we want his bucket
-* @return the size of the bucket fo the key we want
- */
-template<class KeyT, class ValueT>
-int HashMap<KeyT, ValueT>::bucketSize(const KeyT &keyToFindBucket) const
-{
-    if(!containsKey(keyToFindBucket))
-    {
-        throw HashMapInvalidKeyException();
-    }
-    int index = _findIndex(keyToFindBucket);
-    return _bucketsVec.at(index).size();
-}
-
-
-/**
-* we erase a key from the hash map
-* @param key the key that we want to erase
-* @return true if we erase, false otherwise.
-*/
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::erase(const KeyT &key)
-{
-    if(!containsKey(key))
-    {
-        return false;
-    }
-    _eraseFromBucketVec(key);
-    _size--;
-    _loadFactor = (double) _size / _capacity;
-    if (_loadFactor < _lowerLoadFactor)
-    {
-        this->_reSize(false);
-    }
-    return true;
-}
-
-/**
-* erase a pair from the bucet by the key
-* @param key the key that we erase
-*/
-template<class KeyT, class ValueT>
-void HashMap<KeyT, ValueT>::_eraseFromBucketVec(const KeyT &key)
-{
-    int index = _findIndex(key);
-    Bucket& bucket = _bucketsVec.at(index);
-    ValueT val = at(key);
-    std :: pair<KeyT, ValueT> pairToRemove(key, val);
-    bucket.erase(std::remove(bucket.begin(), bucket.end(), pairToRemove), bucket.end());
-}
-
-/**
-* default move assignment
-* @param other other to assign to
-* @return the assigned member
-*/
-template<class KeyT, class ValueT>
-void HashMap<KeyT, ValueT>::clear()
-{
-    for(auto& bucket : _bucketsVec)
-    {
-        bucket.clear();
-    }
-    _size = 0;
-}
-
-
-/**
-* overloading the operator []
-* @param key the key that we want is value
-* @return the value of the key in the hash map
-*/
-template<class KeyT, class ValueT>
-ValueT &HashMap<KeyT, ValueT>::operator[](const KeyT &key)
-{
-    if(containsKey(key))
-    {
-        return at(key);
-    }
-    ValueT toAdd;
-    if (insert(key, toAdd))
-    {
-        return at(key);
-    }
-}
-
-/**
-* overloading the operator []
-* @param key the key that we want is value
-* @return the value of the key in the hash map
- */
-template<class KeyT, class ValueT>
-const ValueT &HashMap<KeyT, ValueT>::operator[](const KeyT &key) const
-{
-    if(containsKey(key))
-    {
-        return at(key);
-    }
-    else
-    {
-        throw(HashMapInvalidKeyException());
-    }
-}
-
-/**
-* overloading the operator []
-* @param other the other hash map that we compering to
-* @return true if this == other , false other wise.
-*/
-template<class KeyT, class ValueT>
-bool HashMap<KeyT, ValueT>::operator==(const HashMap<KeyT, ValueT> &other) const
-{
-
-    if (_lowerLoadFactor != other._lowerLoadFactor || _size != other._size ||
-        _capacity != other._capacity || _upperLoadFactor != other._upperLoadFactor)
-    {
-        return false;
-    }
-    for (int i = 0; i < _capacity  ; i++)
-    {
-        for(auto& pair : _bucketsVec.at(i))
-        {
-            if (std::find(other._bucketsVec[i].begin(), other._bucketsVec[i].end(), pair)
-                == other._bucketsVec[i].end())
-            {
-                return false;
-            }
-        }
-    }
-    return true;
-
-
-}
-
-/**
-* this is an help funck to the vector const, its insertingg the pairs from the vectors to the hash map
-* @param key the key that we insert
-* @param value the value we insert
-*/
-template<class KeyT, class ValueT>
-void HashMap<KeyT, ValueT>::_vectorInsert(const KeyT &key, const ValueT &value)
-{
-    if(containsKey(key))
-    {
-       this->at(key) = value;
-
-    }
-    else
-    {
-        insert(key, value);
-    }
-
-}
-
-
-#endif //EX3_HASHMAP_HPP
+//
+// Created by gueta on 13/09/2019.
+//
+
+#ifndef EX3_HASHMAP_HPP
+#define EX3_HASHMAP_HPP
+
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <type_traits>
+#include <tuple>
+#include <functional>
+#include <scoped_allocator>
+#include "HashMapStorage.hpp"
+#include "HashMapHash.hpp"
+#include "HashMapAllocator.hpp"
+#include "HashMapStats.hpp"
+#include "HashMapFilter.hpp"
+
+
+#define CAPACITY 16
+#define SIZE 0
+#define LOWER_BOUND 0.25
+#define UPPER_BOUND 0.75
+#define MAX_CAPACITY (1 << 30)
+#define HASHMAP_CTOR_INVALID_MSG "HashMap Constructor Invalid Input"
+#define HASHMAP_KEY_NOT_FOUND_MSG "HashMap at Invalid Input: key not found"
+
+
+
+/// ###### exceptions #######
+/**
+ * the InvalidInputException is an abstract class represents an invalid
+ */
+class InvalidInputException: public std::exception
+{
+public:
+    /**
+    * @return the error msg to std cerr in case of this error
+    */
+    virtual const char* what() const noexcept override = 0;
+};
+
+/**
+ * the HashMapInvalidInputException is an abstract class represents an invalid input to the HashMap
+ * class
+ */
+class HashMapInvalidInputException : public InvalidInputException
+{
+    /**
+    * @return the error msg to std cerr in case of this error
+    */
+    virtual const char* what() const noexcept override = 0;
+
+};
+
+/**
+ * the HashMapInvalidInputConstructorException class represents an invalid input to the HashMap
+ * Constructor
+ */
+class HashMapInvalidInputConstructorException : public HashMapInvalidInputException
+{
+    /**
+    * @return the error msg to std cerr in case of this error
+    */
+    inline const char* what() const noexcept override { return HASHMAP_CTOR_INVALID_MSG; }
+};
+
+/**
+ * the HashMapInvalidInputKeyException class represents an invalid input to the HashMap
+ * functions that require to find a key and it does not exist
+ */
+class HashMapInvalidKeyException : public HashMapInvalidInputException
+{
+    /**
+    * @return the error msg to std cerr in case of this error
+    */
+    inline const char* what() const noexcept override { return HASHMAP_KEY_NOT_FOUND_MSG; }
+};
+
+
+
+/// ### end of exceptions ###///
+
+
+/**
+ * when the table of a HashMap gets smaller after erases
+ */
+enum class ShrinkPolicy
+{
+    /** halve the table as soon as the load factor drops below the lower load factor (the default) */
+    EAGER,
+    /**
+     * shrink only below half the lower load factor, and only after at least as many inserts and erases
+     * since the last resize as the pairs that the shrink moves, so a map that goes up and down within a
+     * factor of 4 never rebuilds and the rebuilds cost O(1) per change. the table shrinks to the
+     * middle of the load factors.
+     */
+    HYSTERESIS,
+    /** shrink only on shrink_to_fit() */
+    ON_REQUEST,
+    /** never shrink, not even on shrink_to_fit() */
+    NEVER
+};
+
+
+
+
+
+/**
+ * this class reprasents hash map
+ * @tparam KeyT the type key of the hash map
+ * @tparam ValueT the type of the value in the hash map
+ * @tparam Storage the storage policy of the table, ChainedBuckets (default) or OpenAddressing
+ * @tparam Hash the hash function of the keys, HashMapHash (default) or FastStringHash for strings
+ * @tparam KeyEqual the equality of the keys, == by default
+ * @tparam Allocator the allocator of the table and the pairs, std::allocator by default, or an
+ * ArenaAllocator / PoolAllocator (HashMapAllocator.hpp)
+ */
+template <class KeyT, class ValueT, class Storage = ChainedBuckets, class Hash = HashMapHash<KeyT>,
+          class KeyEqual = std::equal_to<>, class Allocator = std::allocator<std::pair<KeyT, ValueT>>>
+class HashMap
+{
+    /** the table of the storage policy, holds the pairs of the hash map */
+    using Table = typename Storage::template Table<KeyT, ValueT, Allocator>;
+
+    /** the filter in front of the lookups of the table */
+    using Filter = HashMapFilter<Allocator>;
+
+public:
+
+    /** the type of the pairs in the hash map */
+    using value_type = std::pair<KeyT, ValueT>;
+
+    /** the allocator of the hash map */
+    using allocator_type = Allocator;
+
+    template <bool IsConst>
+    class Iterator;
+
+private:
+
+    /**
+     * the overloads that take a K exist only when the hash function and the key equality are transparent, and
+     * not for the iterators of the map, so erase(iterator) is not taken as an erase of a key, like in the
+     * standard containers
+     */
+    template <class K, class H, class E>
+    using _TransparentKey = std::enable_if_t<!std::is_convertible_v<const K&, Iterator<false>> &&
+                                             !std::is_convertible_v<const K&, Iterator<true>>, IsTransparent<H, E>>;
+
+    /** the hash map lower load factor*/
+    double _lowerLoadFactor;
+
+     /** the hash map upper load factor*/
+     double _upperLoadFactor;
+
+    /** numbet of pairs in the hash map*/
+    int _size;
+
+
+    /** the load factor of the hash map */
+    double _loadFactor;
+
+    /** the hash function we use to map the elemant*/
+    Hash _hash;
+
+    /** the equality we use to compare the keys*/
+    KeyEqual _keyEqual;
+
+    /** the table of the storage policy, represents the hash table*/
+    Table _table;
+
+    /**
+     * the table before the last resize while an incremental rehash moves its buckets to _table,
+     * it has no buckets when there is no rehash in progress
+     */
+    Table _oldTable;
+
+    /** the next bucket of _oldTable that an incremental rehash moves */
+    int _rehashCursor;
+
+    /** number of buckets that an incremental rehash moves on every change of the map, 0 to rehash at once */
+    int _rehashStep;
+
+    /**
+     * number of buckets that the rehash in progress moves on every change of the map, at least _rehashStep and
+     * enough to empty the old table before the changes can resize the table again
+     */
+    int _rehashPace;
+
+    /** when the table shrinks */
+    ShrinkPolicy _shrinkPolicy;
+
+    /** the table never shrinks below this capacity */
+    int _minCapacity;
+
+    /** number of inserts and erases since the last resize */
+    long _changesSinceResize;
+
+    /** number of times the table grew */
+    long _grows;
+
+    /** number of times the table shrank */
+    long _shrinks;
+
+    /** the false positive rate of the filter, 0 when the hash map has no filter */
+    double _filterRate;
+
+    /** the bits of the filter for every pair that the table holds below the upper load factor */
+    double _filterBitsPerKey;
+
+    /** the filter of the hashes of all the keys, of both tables while they are rehashed */
+    Filter _filter;
+
+    /** the filter of _table alone while an incremental rehash moves the pairs to it, it replaces _filter then */
+    Filter _nextFilter;
+
+    /** the lookup and resize time counters, they count only with HASHMAP_STATS */
+    mutable HashMapCounters<HASHMAP_STATS != 0> _counters;
+
+    /** times a resize for the counters */
+    using ResizeTimer = typename HashMapCounters<HASHMAP_STATS != 0>::Timer;
+
+    /**
+     * insert a new pair to the table, the table grows before the insertion if the pair would take
+     * it above the upper load factor. the caller is responsible that the key is not in the hash map
+     * @param hash the hash of the key
+     * @param args the args that the pair is constructed from
+     * @return pointer to the new pair in the table
+     */
+    template <class... Args>
+    value_type* _insertNew(size_t hash, Args&&... args);
+
+    /**
+     * the single lookup path of the hash map, it hashes the key once and probes the table once
+     * @param key the key that we look for, a KeyT or a type the hash function is transparent to
+     * @return pointer to the pair of the key in the table, nullptr if the key is not there
+     */
+    template <class K>
+    value_type* _find(const K& key) { return _find(_hashOf(key), key); }
+
+    /**
+     * the single lookup path of the hash map, it hashes the key once and probes the table once
+     * @param key the key that we look for, a KeyT or a type the hash function is transparent to
+     * @return pointer to the pair of the key in the table, nullptr if the key is not there
+     */
+    template <class K>
+    const value_type* _find(const K& key) const { return _find(_hashOf(key), key); }
+
+    /**
+     * find a key that is already hashed, in the old table too while it is rehashed
+     * @param hash the hash of the key
+     * @param key the key that we look for
+     * @return pointer to the pair of the key in the table, nullptr if the key is not there
+     */
+    template <class K>
+    value_type* _find(size_t hash, const K& key)
+    {
+        if (!_filter.mayContain(hash))
+        {
+            _counters.filterReject();
+            _counters.lookup(false);
+            return nullptr;
+        }
+        value_type* found = _table.find(hash, _matcher(key));
+        if (found == nullptr && _isRehashing())
+        {
+            found = _oldTable.find(hash, _matcher(key));
+        }
+        _counters.lookup(found != nullptr);
+        if (found == nullptr && _filter.enabled())
+        {
+            _counters.falsePositive();
+        }
+        return found;
+    }
+
+    /**
+     * find a key that is already hashed, in the old table too while it is rehashed
+     * @param hash the hash of the key
+     * @param key the key that we look for
+     * @return pointer to the pair of the key in the table, nullptr if the key is not there
+     */
+    template <class K>
+    const value_type* _find(size_t hash, const K& key) const
+    {
+        return const_cast<HashMap*>(this)->_find(hash, key);
+    }
+
+    /**
+     * @param key the key that we hash
+     * @return the hash of the key, the table maps it to a bucket
+     */
+    template <class K>
+    size_t _hashOf(const K& key) const
+    {
+        if constexpr (IsAvalanching<Hash>::value)
+        {
+            return _hash(key);
+        }
+        else
+        {
+            return hashIndexMix(_hash(key));
+        }
+    }
+
+    /**
+     * @param key the key that we look for
+     * @return predicate that returns true for a key that equals to the given key
+     */
+    template <class K>
+    auto _matcher(const K& key) const
+    {
+        return [this, &key](const KeyT& other) { return _keyEqual(other, key); };
+    }
+
+    /**
+     * @param found the pair that a lookup found
+     * @return the value of the pair
+     * @throw HashMapInvalidKeyException if the lookup did not find the key
+     */
+    static ValueT& _valueOf(value_type* found)
+    {
+        if(found == nullptr)
+        {
+            throw HashMapInvalidKeyException();
+        }
+        return found->second;
+    }
+
+    /**
+     * @param found the pair that a lookup found
+     * @return the value of the pair
+     * @throw HashMapInvalidKeyException if the lookup did not find the key
+     */
+    static const ValueT& _valueOf(const value_type* found)
+    {
+        if(found == nullptr)
+        {
+            throw HashMapInvalidKeyException();
+        }
+        return found->second;
+    }
+
+    /**
+     * erase a key from the hash map
+     * @param key the key that we want to erase
+     * @return true if we erase, false otherwise.
+     */
+    template <class K>
+    bool _erase(const K& key);
+
+    /**
+     * find a key and make an iterator that points to its pair
+     * @param key the key that we look for
+     * @return iterator to the pair of the key, end() if the key is not there
+     */
+    template <class K>
+    auto _findIterator(const K& key);
+
+    /**
+     * @param filter the filter of the table that gets the pairs
+     * @return function that returns the hash of a key and adds it to the filter, the tables use it to move
+     * their pairs
+     */
+    auto _hasher(Filter* filter) const
+    {
+        return [this, filter](const KeyT& key)
+        {
+            size_t hash = _hashOf(key);
+            filter->add(hash);
+            return hash;
+        };
+    }
+
+    /**
+     * @param capacity the capacity of a table
+     * @return an empty filter for the pairs that the table holds below the upper load factor, it is off when
+     * the hash map has no filter
+     */
+    Filter _makeFilter(int capacity) const
+    {
+        if (_filterRate == 0)
+        {
+            return Filter(_table.allocator());
+        }
+        return Filter((size_t) std::ceil(capacity * _upperLoadFactor), _filterBitsPerKey, _table.allocator());
+    }
+
+    /**
+     * build the filter again from the keys in the hash map, without the bits of the erased keys
+     */
+    void _rebuildFilter();
+
+    /**
+     *
+     * @return true if an incremental rehash is in progress
+     */
+    bool _isRehashing() const { return _oldTable.capacity() != 0; }
+
+    /**
+     * move the next _rehashPace buckets of the old table to the table, and drop the old table
+     * once it is empty
+     */
+    void _rehashSome();
+
+    /**
+     * move all the buckets that are left in the old table to the table
+     */
+    void _finishRehash();
+
+    /**
+     * re size the capacity of the hash map acoording to the bool given
+     * @param inLarge if true we inlarge the table , if false we shrink.
+     */
+    void _reSize(const bool inLarge);
+
+    /**
+     *
+     * @return the capacity that the table shrinks to after an erase by the shrink policy, the
+     * current capacity if it does not shrink
+     */
+    int _shrinkCapacity() const;
+
+    /**
+     * count a change of the capacity in the resize counters
+     * @param newCap the capacity after the resize
+     */
+    void _countResize(int newCap)
+    {
+        _grows += newCap > capacity();
+        _shrinks += newCap < capacity();
+        _changesSinceResize = 0;
+    }
+
+    /**
+     * insert a pair whose value is constructed in place from args, only if the key is not in the
+     * hash map yet
+     * @param key the key that we insert, moved from if it is an rvalue
+     * @param args the args that the value is constructed from
+     * @return true if the insertion was sueccsid false oherwise
+     */
+    template <class K, class... Args>
+    bool _tryEmplace(K&& key, Args&&... args);
+
+    /**
+     * @param count number of pairs
+     * @return the smallest capacity (a power of 2) that holds count pairs below the upper load factor
+     */
+    int _capacityFor(int count) const
+    {
+        int newCap = 1;
+        while (count > newCap * _upperLoadFactor)
+        {
+            newCap *= 2;
+        }
+        return newCap;
+    }
+
+
+
+
+
+public:
+
+    /**
+     *
+     * @param lowerLoadFactor lowerLoadFactor of the table
+     * @param upperLoadFactor upperLoadFactor of the table
+     * @param allocator the allocator of the table and the pairs
+     */
+    HashMap(double lowerLoadFactor, double upperLoadFactor, const Allocator& allocator):
+            _lowerLoadFactor(lowerLoadFactor), _upperLoadFactor(upperLoadFactor), _size(SIZE), _loadFactor(0.0),
+            _table(CAPACITY, allocator), _oldTable(0, allocator), _rehashCursor(0), _rehashStep(0),
+            _rehashPace(0),
+            _shrinkPolicy(ShrinkPolicy::EAGER), _minCapacity(1), _changesSinceResize(0), _grows(0), _shrinks(0),
+            _filterRate(0), _filterBitsPerKey(0), _filter(allocator), _nextFilter(allocator)
+
+    {
+        if (lowerLoadFactor >= upperLoadFactor)
+        {
+            throw HashMapInvalidInputConstructorException();
+        }
+        if (lowerLoadFactor > 1 || upperLoadFactor > 1 ||
+            lowerLoadFactor < 0  || upperLoadFactor < 0)
+        {
+            throw HashMapInvalidInputConstructorException();
+        }
+    };
+
+    /**
+     *
+     * @param lowerLoadFactor lowerLoadFactor of the table
+     * @param upperLoadFactor upperLoadFactor of the table
+     */
+    HashMap(double lowerLoadFactor, double upperLoadFactor): HashMap(lowerLoadFactor, upperLoadFactor, Allocator()){}
+
+    /**
+     * efault constructor sets the lower factor to 0.25 and upper factor to 0.75
+     */
+    HashMap(): HashMap(LOWER_BOUND, UPPER_BOUND){};
+
+    /**
+     * constructor with the default load factors that allocates through the given allocator, for
+     * example an ArenaAllocator of the arena that the map is built in
+     * @param allocator the allocator of the table and the pairs
+     */
+    explicit HashMap(const Allocator& allocator): HashMap(LOWER_BOUND, UPPER_BOUND, allocator){}
+
+    /**
+     * Receiving two vectors of keys and values, this constructor sets the map through that
+     * @param keyVector vector of keys.
+     * @param valuesVector vector of values.
+     */
+    HashMap(std::vector<KeyT> keyVector, std::vector<ValueT> valuesVector):
+            HashMap(LOWER_BOUND, UPPER_BOUND)
+    {
+        if (keyVector.size() != valuesVector.size())
+        {
+            throw HashMapInvalidInputConstructorException();
+        }
+        reserve((int) keyVector.size());
+        for (int i = 0; i < (int) keyVector.size(); i++)
+        {
+            insert_or_assign(std::move(keyVector[i]), std::move(valuesVector[i]));
+        }
+    }
+
+    /**
+     * Receiving a range of pairs, this constructor sizes the table once for the whole range and
+     * then sets the map through it. like in the vectors constructor, a later pair of a key
+     * overrides an earlier one. the pairs are moved from when the iterators are move iterators.
+     * @param first iterator to the first pair of the range
+     * @param last iterator past the last pair of the range
+     */
+    template <class InputIt, class = typename std::iterator_traits<InputIt>::iterator_category>
+    HashMap(InputIt first, InputIt last): HashMap(LOWER_BOUND, UPPER_BOUND)
+    {
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value)
+        {
+            reserve((int) std::distance(first, last));
+        }
+        for (; first != last; ++first)
+        {
+            auto&& pair = *first;
+            insert_or_assign(std::forward<decltype(pair)>(pair).first,
+                             std::forward<decltype(pair)>(pair).second);
+        }
+    }
+
+    /**
+     * copy constructor
+     * @param other the other HashMap that been copied
+     */
+    HashMap(HashMap &  other) = default;
+
+    /**
+     * copy move constructor
+     * @param other other the other HashMap that been copied
+     */
+    HashMap(HashMap &&  other) = default;
+
+    /**
+     * distructor
+     */
+    ~HashMap() = default;
+
+    /**
+     *
+     * @return the number of buckets in the table
+     */
+    int capacity() const{ return _table.capacity(); }
+
+    /**
+     *
+     * @return the allocator of the hash map
+     */
+    Allocator get_allocator() const { return _table.allocator(); }
+
+    /**
+     *
+     * @return _size/
+     */
+    int size() const { return _size; }
+
+    /**
+     *
+     * @return _loadFactor
+     */
+    double getLoadFactor() const {return _loadFactor; }
+
+    /**
+     * grow the table so it holds count pairs without another resize
+     * @param count the number of pairs the table should hold
+     */
+    void reserve(int count)
+    {
+        if (_capacityFor(count) > capacity())
+        {
+            rehash(_capacityFor(count));
+        }
+    }
+
+    /**
+     * set the number of buckets of the table at once, the pairs are moved to their new buckets
+     * @param buckets the wanted number of buckets, it is rounded up to a power of 2 and to the
+     * capacity that holds all the pairs below the upper load factor
+     */
+    void rehash(int buckets);
+
+    /**
+     * choose how the table is rehashed when it grows or shrinks. by default all the pairs are moved
+     * to the new table at once, so a single insert or erase may take O(n). with an incremental
+     * rehash the old table is kept next to the new one, and every insert and erase moves the next
+     * bucketsPerStep buckets of it, or more if the old table would not be empty before the inserts or
+     * erases can resize the table again (about 4 buckets at the default load factors). so an insert or
+     * erase moves a few buckets and never the whole table. rehash, reserve, setFilter and turning the
+     * incremental rehash off still move all the buckets that are left at once.
+     * @param bucketsPerStep number of buckets to move on every change of the map, 0 to rehash at once
+     */
+    void setRehashStep(int bucketsPerStep)
+    {
+        _rehashStep = std::max(bucketsPerStep, 0);
+        if (_rehashStep == 0)
+        {
+            _finishRehash();
+        }
+    }
+
+    /**
+     * choose when the table shrinks after erases, a map that keeps growing and shrinking around the
+     * same size should not shrink eagerly
+     * @param policy the shrink policy, EAGER by default
+     * @param minCapacity the table never shrinks below this capacity, it is rounded up to a power of 2 (at most 2^30)
+     */
+    void setShrinkPolicy(ShrinkPolicy policy, int minCapacity = 1)
+    {
+        _shrinkPolicy = policy;
+        // the largest power of 2 an int holds, the doubling below would overflow past it
+        minCapacity = std::min(minCapacity, MAX_CAPACITY);
+        _minCapacity = 1;
+        while (_minCapacity < minCapacity)
+        {
+            _minCapacity *= 2;
+        }
+    }
+
+    /**
+     *
+     * @return the shrink policy of the hash map
+     */
+    ShrinkPolicy getShrinkPolicy() const { return _shrinkPolicy; }
+
+    /**
+     * shrink the table to the smallest capacity (not below the minimum capacity) that holds the pairs
+     * below the upper load factor, unless the shrink policy is NEVER
+     */
+    void shrink_to_fit()
+    {
+        if (_shrinkPolicy != ShrinkPolicy::NEVER)
+        {
+            rehash(_minCapacity);
+        }
+    }
+
+    /**
+     * put a filter in front of the lookups, a lookup of a key that is not in the map then reads one cache
+     * line of the filter and (but for about falsePositiveRate of them) never gets to the table. the filter is
+     * sized with the table and built again whenever the table is, an erased key stays in it until then
+     * @param falsePositiveRate the false positive rate of the filter when the table is full, 0 to drop the filter
+     */
+    void setFilter(double falsePositiveRate);
+
+    /**
+     *
+     * @return the false positive rate that the filter was set to, 0 when the hash map has no filter
+     */
+    double getFilterRate() const { return _filterRate; }
+
+    /**
+     *
+     * @return the number of times the table grew
+     */
+    long growCount() const { return _grows; }
+
+    /**
+     *
+     * @return the number of times the table shrank
+     */
+    long shrinkCount() const { return _shrinks; }
+
+    /**
+     * the stats of the hash map: the bucket length histogram, the probe lengths, the resizes and the
+     * bytes of the table, and with HASHMAP_STATS the lookup hits / misses and the time spent resizing.
+     * the shape of the table is walked here, so it takes time of the capacity
+     * @return the stats
+     */
+    HashMapStats stats() const;
+
+    /**
+     * forget the lookups and the resize time that were counted so far (HASHMAP_STATS), so stats() counts only
+     * what comes after, for example the lookups of the messages and not the ones that built the map
+     */
+    void resetStats() { _counters = HashMapCounters<HASHMAP_STATS != 0>(); }
+
+    /**
+     *
+     * @return true if the hash Map is empty false otherwise.
+     */
+    bool empty() const { return  (_size == 0); }
+
+    /**
+     * insert a pair the to hash map
+     * @param key the key that we insert
+     * @param value the value that we insert
+     * @return true if the insertion was sueccsid false oherwise
+     */
+    bool insert(const KeyT& key, const ValueT& value) { return _tryEmplace(key, value); }
+
+    /**
+     * insert a pair the to hash map, the key and the value are moved into the table
+     * @param key the key that we insert
+     * @param value the value that we insert
+     * @return true if the insertion was sueccsid false oherwise
+     */
+    bool insert(KeyT&& key, ValueT&& value) { return _tryEmplace(std::move(key), std::move(value)); }
+
+    /**
+     * insert a pair that is constructed from args. the pair has to be constructed to know its key,
+     * so when the key is already in the hash map it is constructed and thrown away, use
+     * try_emplace to avoid that.
+     * @param args the args that the pair is constructed from
+     * @return true if the insertion was sueccsid false oherwise
+     */
+    template <class... Args>
+    bool emplace(Args&&... args);
+
+    /**
+     * insert a pair whose value is constructed in place from args. if the key is already in the
+     * hash map nothing is constructed and nothing is moved from.
+     * @param key the key that we insert
+     * @param args the args that the value is constructed from
+     * @return true if the insertion was sueccsid false oherwise
+     */
+    template <class... Args>
+    bool try_emplace(const KeyT& key, Args&&... args)
+    {
+        return _tryEmplace(key, std::forward<Args>(args)...);
+    }
+
+    /**
+     * insert a pair whose value is constructed in place from args. if the key is already in the
+     * hash map nothing is constructed and nothing is moved from.
+     * @param key the key that we insert, it is moved into the table
+     * @param args the args that the value is constructed from
+     * @return true if the insertion was sueccsid false oherwise
+     */
+    template <class... Args>
+    bool try_emplace(KeyT&& key, Args&&... args)
+    {
+        return _tryEmplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /**
+     * insert a pair, or assign the value to the key if it is already in the hash map
+     * @param key the key that we insert, moved from if it is an rvalue
+     * @param value the value that we insert or assign, moved from if it is an rvalue
+     * @return true if the pair was inserted, false if the value was assigned
+     */
+    template <class K, class V>
+    bool insert_or_assign(K&& key, V&& value);
+
+    /**
+     * checks if hash map contains a certion key
+     * @param key the key that we check if is containing
+     * @return true if so false otherwise
+     */
+    bool containsKey(const KeyT& key) const ;
+
+    /**
+     * checks if hash map contains a certion key, without making a KeyT from it. this overload and
+     * the other overloads that take a K exist only when the hash function and the key equality
+     * are transparent, see HashMapHash<std::string>
+     * @param key the key that we check if is containing, for example a std::string_view
+     * @return true if so false otherwise
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = _TransparentKey<K, H, E>>
+    bool containsKey(const K& key) const { return _find(key) != nullptr; }
+
+    /**
+     *
+     * @param key the key that we look for is value
+     * @return the value of the key in the hash map
+     */
+    const ValueT& at(const KeyT& key) const;
+
+    /**
+    *
+    * @param key the key that we look for is value
+    * @return the value of the key in the hash map
+    */
+    ValueT& at(const KeyT& key);
+
+    /**
+     *
+     * @param key the key that we look for is value, for example a std::string_view
+     * @return the value of the key in the hash map
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = _TransparentKey<K, H, E>>
+    const ValueT& at(const K& key) const { return _valueOf(_find(key)); }
+
+    /**
+     *
+     * @param key the key that we look for is value, for example a std::string_view
+     * @return the value of the key in the hash map
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = _TransparentKey<K, H, E>>
+    ValueT& at(const K& key) { return _valueOf(_find(key)); }
+
+
+    /**
+     *
+     * @param keyToFindBucket the key that we want his bucket
+     * @return the size of the bucket fo the key we want
+     */
+    int bucketSize (const KeyT& keyToFindBucket) const;
+
+    /**
+     * overloading the operator !=
+     * @param other the other we doing the != with
+     * @return true if this != other , false otherwise
+     */
+    inline bool operator!=(const HashMap& other) const { return !(*this == other); }
+
+    /**
+     * overloading the operator =
+     * @param other the other that we asiigen this to
+     * @return this
+     */
+    HashMap& operator=(const HashMap& other) = default;
+
+    /**
+     * we erase a key from the hash map
+     * @param key the key that we want to erase
+     * @return true if we erase, false otherwise.
+     */
+    bool erase(const KeyT& key) { return _erase(key); }
+
+    /**
+     * we erase a key from the hash map
+     * @param key the key that we want to erase, for example a std::string_view
+     * @return true if we erase, false otherwise.
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = _TransparentKey<K, H, E>>
+    bool erase(const K& key) { return _erase(key); }
+
+    /**
+     * clear all the hash map/
+     */
+    void clear();
+
+    /**
+     * default move assignment
+     * @param other other to assign to
+     * @return the assigned member
+     */
+    HashMap& operator=(HashMap && other) noexcept = default;
+    /**
+     * the function return the begin of the hash map iterator
+     * @return iterator object, points to the begin
+     */
+
+    /**
+     * overloading the operator []
+     * @param key the key that we want is value
+     * @return the value of the key in the hash map
+     */
+    ValueT& operator[](const KeyT& key);
+
+    /**
+     * overloading the operator []
+     * @param key the key that we want is value
+     * @return the value of the key in the hash map
+     */
+    const ValueT& operator[](const KeyT& key) const;
+
+    /**
+     * overloading the operator []
+     * @param other the other hash map that we compering to
+     * @return true if this == other , false other wise.
+     */
+    bool operator==(const HashMap& other) const;
+
+    /**
+     * Class that enables iterating over the map. it walks the runs of pairs that the storage policy
+     * hands out (a bucket, or consecutive occupied slots), so a step is a pointer increment and the
+     * empty parts of the table are skipped a run at a time. the table is walked first, then the old
+     * table while an incremental rehash is in progress.
+     * any insert invalidates the iterators, an erase by key invalidates them too, erase(iterator)
+     * keeps the returned iterator valid.
+     * @tparam IsConst true for the const_iterator, false for the iterator
+     */
+    template <bool IsConst>
+    class Iterator
+    {
+
+    private:
+
+        friend class HashMap;
+
+        template <bool>
+        friend class Iterator;
+
+        /** pointer to the hash map */
+        HashMap *_map;
+
+        /** the pair that the iterator points to, nullptr at the end */
+        std::pair<KeyT, ValueT> *_pair;
+
+        /** the run of the pair */
+        TableRun<std::pair<KeyT, ValueT>> _run;
+
+        /** where the iteration of the current table started, see iterationStart */
+        int _start;
+
+        /** true while the iterator is in the old table of an incremental rehash */
+        bool _inOld;
+
+        /**
+         * Constructor of the iterator
+         * @param map pointer of hashmap
+         * @param run the run that the iterator starts at, the next run is looked for if it is empty
+         * @param start where the iteration of the table started
+         * @param inOld true if the run is in the old table
+         */
+        Iterator(HashMap *map, TableRun<std::pair<KeyT, ValueT>> run, int start, bool inOld)
+                : _map(map), _pair(run.first), _run(run), _start(start), _inOld(inOld)
+        {
+            if(_pair == nullptr || _pair == _run.last)
+            {
+                _nextRun();
+            }
+        }
+
+        /**
+         * move to the first pair of the next run, and from the table to the old table
+         */
+        void _nextRun()
+        {
+            Table& table = _inOld ? _map->_oldTable : _map->_table;
+            _run = table.nextRun(_run.next, _start);
+            if(_run.first == nullptr && !_inOld && _map->_isRehashing())
+            {
+                _inOld = true;
+                _start = _map->_oldTable.iterationStart();
+                _run = _map->_oldTable.nextRun(0, _start);
+            }
+            _pair = _run.first;
+        }
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<KeyT, ValueT>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<IsConst, const value_type*, value_type*>::type;
+        using reference = typename std::conditional<IsConst, const value_type&, value_type&>::type;
+
+        /**
+         * an iterator that points to nothing
+         */
+        Iterator() : _map(nullptr), _pair(nullptr), _run{nullptr, nullptr, 0, 0}, _start(0), _inOld(false) {}
+
+        /**
+         * an iterator converts to a const_iterator
+         * @param other the iterator
+         */
+        template <bool C = IsConst, class = typename std::enable_if<C>::type>
+        Iterator(const Iterator<false>& other)
+                : _map(other._map), _pair(other._pair), _run(other._run), _start(other._start),
+                  _inOld(other._inOld) {}
+
+        /**
+         * overloading the operator ++this
+         * @return this
+         */
+        Iterator& operator++()
+        {
+            if(++_pair == _run.last)
+            {
+                _nextRun();
+            }
+            return *this;
+        }
+
+        /**
+         * overloading the operator this++
+         * @return this
+         */
+        Iterator operator++(int)
+        {
+            Iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        /**
+         * overloading the operator *. the key of the pair must not be changed through an iterator
+         * @return the pair that in that index
+         */
+        reference operator*() const { return *_pair; }
+
+        /**
+         * overloading the operator ->
+         * @return the pointer to the pair that in that index
+         */
+        pointer operator->() const { return _pair; }
+
+        /**
+         * overloading the operator ==, an iterator and a const_iterator compare too
+         * @param other the other iterator we == with
+         * @return true if this == other ' false otherwise
+         */
+        friend bool operator==(const Iterator& first, const Iterator& other) { return first._pair == other._pair; }
+
+        /**
+         * overloading the operator !=
+         * @param other the other iterator we != with
+         * @return true if this != other ' false otherwise
+         */
+        friend bool operator!=(const Iterator& first, const Iterator& other) { return first._pair != other._pair; }
+    };
+
+    /** iterator over the pairs, the values can be changed through it */
+    using iterator = Iterator<false>;
+
+    /** iterator over the pairs, where the map stays constant */
+    using const_iterator = Iterator<true>;
+
+    /**
+     * First iterator of the hash map
+     * @return the iterator of the beginning of the map
+     */
+    iterator begin()
+    {
+        int start = _table.iterationStart();
+        return iterator(this, _table.nextRun(0, start), start, false);
+    }
+
+    /**
+     * last iterator of the hash map
+     * @return he iterator of the end of the map
+     */
+    iterator end() { return iterator(); }
+
+    /**
+     * First iterator of the hash map
+     * @return the iterator of the beginning of the map
+     */
+    const_iterator begin() const { return const_cast<HashMap*>(this)->begin(); }
+
+    /**
+     * last iterator of the hash map
+     * @return he iterator of the end of the map
+     */
+    const_iterator end() const { return const_iterator(); }
+
+    /**
+    * First iterator of the hash map
+    * @return the iterator of the beginning of the map
+    */
+    const_iterator cbegin() const { return begin(); }
+
+    /**
+    * last iterator of the hash map
+    * @return the iterator of the end of the map
+    */
+    const_iterator cend() const { return end(); }
+
+    /**
+     * find a key in the hash map
+     * @param key the key that we look for
+     * @return iterator to the pair of the key, end() if the key is not in the hash map
+     */
+    iterator find(const KeyT& key) { return _findIterator(key); }
+
+    /**
+     * find a key in the hash map
+     * @param key the key that we look for, for example a std::string_view
+     * @return iterator to the pair of the key, end() if the key is not in the hash map
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = _TransparentKey<K, H, E>>
+    iterator find(const K& key) { return _findIterator(key); }
+
+    /**
+     * find a key in the hash map
+     * @param key the key that we look for
+     * @return iterator to the pair of the key, end() if the key is not in the hash map
+     */
+    const_iterator find(const KeyT& key) const { return const_cast<HashMap*>(this)->_findIterator(key); }
+
+    /**
+     * find a key in the hash map
+     * @param key the key that we look for, for example a std::string_view
+     * @return iterator to the pair of the key, end() if the key is not in the hash map
+     */
+    template <class K, class H = Hash, class E = KeyEqual, class = _TransparentKey<K, H, E>>
+    const_iterator find(const K& key) const { return const_cast<HashMap*>(this)->_findIterator(key); }
+
+    /**
+     * erase the pair that an iterator points to. the table does not resize here, so an iteration can
+     * erase the pairs it goes over: it goes on from the returned iterator, and visits every other pair
+     * once.
+     * @param position iterator to a pair of this hash map
+     * @return iterator to the pair that came after the erased one, end() if it was the last
+     */
+    iterator erase(const_iterator position);
+
+    /**
+     * erase the pair that an iterator points to, see erase(const_iterator)
+     * @param position iterator to a pair of this hash map
+     * @return iterator to the pair that came after the erased one, end() if it was the last
+     */
+    iterator erase(iterator position) { return erase(const_iterator(position)); }
+
+
+
+};
+
+
+
+/**
+ * erase the pair that an iterator points to, the table does not resize
+ * @param position iterator to a pair of this hash map
+ * @return iterator to the pair that came after the erased one, end() if it was the last
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+typename HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::iterator
+HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::erase(const_iterator position)
+{
+    iterator next;
+    next._map = this;
+    next._run = position._run;
+    next._start = position._start;
+    next._inOld = position._inOld;
+    (position._inOld ? _oldTable : _table).eraseInRun(&next._run, position._pair);
+    next._pair = position._pair;
+    _size--;
+    _changesSinceResize++;
+    _loadFactor = (double) _size / capacity();
+    if(next._pair == next._run.last)
+    {
+        next._nextRun();
+    }
+    return next;
+}
+
+/**
+ * insert a pair whose value is constructed in place from args, only if the key is not in the
+ * hash map yet
+ * @param key the key that we insert, moved from if it is an rvalue
+ * @param args the args that the value is constructed from
+ * @return true if the insertion was sueccsid false oherwise
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+template<class K, class... Args>
+bool HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::_tryEmplace(K&& key, Args&&... args)
+{
+    size_t hash = _hashOf(key);
+    if(_find(hash, key) != nullptr)
+    {
+        return false;
+    }
+    _insertNew(hash, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+               std::forward_as_tuple(std::forward<Args>(args)...));
+    return true;
+}
+
+/**
+ * insert a pair that is constructed from args
+ * @param args the args that the pair is constructed from
+ * @return true if the insertion was sueccsid false oherwise
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+template<class... Args>
+bool HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::emplace(Args&&... args)
+{
+    value_type pair(std::forward<Args>(args)...);
+    size_t hash = _hashOf(pair.first);
+    if(_find(hash, pair.first) != nullptr)
+    {
+        return false;
+    }
+    _insertNew(hash, std::move(pair));
+    return true;
+}
+
+
+/**
+ * checks if hash map contains a certion key
+ * @param key the key that we check if is containing
+ * @return true if so false otherwise
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+bool HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::containsKey(const KeyT& key) const
+{
+   return _find(key) != nullptr;
+}
+
+
+/**
+ * insert a new pair to the table and grow the table if needed, the caller is responsible
+ * that the key is not in the hash map
+ * @param hash the hash of the key
+ * @param key the key that we add to the table
+ * @param value the value the pair in the table
+ * @return pointer to the new pair in the table
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+template<class... Args>
+typename HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::value_type *
+HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::_insertNew(size_t hash, Args&&... args)
+{
+    _rehashSome();
+    if ((double) (_size + 1) / capacity() > _upperLoadFactor)
+    {
+        // growing first keeps the returned pointer valid, and an open addressing table never fills up
+        this->_reSize(true);
+    }
+    value_type* inserted = _table.insertUnique(hash, std::forward<Args>(args)...);
+    _size ++;
+    _changesSinceResize++;
+    _loadFactor = (double) _size / capacity();
+    _filter.add(hash);
+    if (_isRehashing())
+    {
+        _nextFilter.add(hash);
+    }
+    else if (_filter.overfull())
+    {
+        // erases and inserts without a resize, most of the bits are of keys that are gone
+        _rebuildFilter();
+    }
+    return inserted;
+}
+
+/**
+ * set the number of buckets of the table at once, the pairs are moved to their new buckets
+ * @param buckets the wanted number of buckets, it is rounded up to a power of 2 and to the
+ * capacity that holds all the pairs below the upper load factor
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+void HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::rehash(int buckets)
+{
+    int newCap = _capacityFor(_size);
+    buckets = std::min(buckets, MAX_CAPACITY);
+    while (newCap < buckets)
+    {
+        newCap *= 2;
+    }
+    ResizeTimer timer(&_counters);
+    _finishRehash();
+    if (newCap != capacity())
+    {
+        _countResize(newCap);
+        Filter filter = _makeFilter(newCap);
+        _table.rehash(newCap, _hasher(&filter));
+        _filter = std::move(filter);
+    }
+    _loadFactor = (double) _size / capacity();
+}
+
+
+/**
+ * re size the capacity of the hash map acoording to the bool given
+ * @param inLarge if true we inlarge the table , if false we shrink.
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+void HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::_reSize(const bool inLarge)
+{
+    int newCap = inLarge ? capacity() * 2 : _shrinkCapacity();
+    if (newCap == capacity())
+    {
+        return;
+    }
+    ResizeTimer timer(&_counters);
+    _finishRehash();
+    _countResize(newCap);
+    if (_rehashStep == 0)
+    {
+        Filter filter = _makeFilter(newCap);
+        _table.rehash(newCap, _hasher(&filter));
+        _filter = std::move(filter);
+    }
+    else
+    {
+        // every insert and erase until the next resize moves _rehashPace buckets, so the old table is empty by
+        // then and the next resize does not move the rest of it at once. the insert that grows the table is
+        // not in _size yet, and the erases count as if the shrink policy were EAGER, the earliest shrink
+        long size = _size + (inLarge ? 1 : 0);
+        long toGrow = (long) std::floor(newCap * _upperLoadFactor) - size + 1;
+        long toShrink = size - (long) std::ceil(newCap * _lowerLoadFactor) + 1;
+        long changes = std::max(std::min(toGrow, toShrink), 1L);
+        _rehashPace = (int) std::max((long) _rehashStep, (capacity() + changes - 1) / changes);
+        _oldTable = std::move(_table);
+        _table = Table(newCap, _table.allocator());
+        _nextFilter = _makeFilter(newCap);
+        _rehashCursor = 0;
+    }
+    _loadFactor = (double) _size / capacity();
+}
+
+/**
+ * @return the capacity that the table shrinks to after an erase by the shrink policy, the current
+ * capacity if it does not shrink
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+int HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::_shrinkCapacity() const
+{
+    int newCap = capacity();
+    switch (_shrinkPolicy)
+    {
+        case ShrinkPolicy::EAGER:
+            // the smaller table would have to grow right back
+            if (capacity() / 2 >= _minCapacity && _size <= capacity() / 2 * _upperLoadFactor)
+            {
+                newCap = capacity() / 2;
+            }
+            break;
+        case ShrinkPolicy::HYSTERESIS:
+            // the shrink moves _size pairs, so it waits until as many changes paid for it
+            if (_loadFactor < _lowerLoadFactor / 2 && _changesSinceResize >= _size)
+            {
+                // land in the middle, as far from growing back as from shrinking again
+                double middle = (_lowerLoadFactor + _upperLoadFactor) / 2;
+                while (newCap / 2 >= _minCapacity && _size <= newCap / 2 * middle)
+                {
+                    newCap /= 2;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    return newCap;
+}
+
+/**
+ * the stats of the hash map, the shape of the table is walked here
+ * @return the stats
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+HashMapStats HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::stats() const
+{
+    HashMapStats stats;
+    _table.collectStats(&stats);
+    if (_isRehashing())
+    {
+        _oldTable.collectStats(&stats);
+    }
+    stats.grows = _grows;
+    stats.shrinks = _shrinks;
+    stats.filterBytes = _filter.bytes() + _nextFilter.bytes();
+    stats.filterTargetRate = _filterRate;
+    stats.filterRate = _filter.enabled() ? _filter.falsePositiveRate() : 0;
+    stats.bytes += sizeof(*this) + stats.filterBytes;
+    _counters.collect(&stats);
+    return stats;
+}
+
+/**
+ * move the next _rehashPace buckets of the old table to the table, and drop the old table
+ * once it is empty
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+void HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::_rehashSome()
+{
+    if (!_isRehashing())
+    {
+        return;
+    }
+    ResizeTimer timer(&_counters);
+    for (int i = 0; i < _rehashPace && _rehashCursor < _oldTable.capacity(); i++)
+    {
+        _oldTable.moveBucketTo(_rehashCursor++, _table, _hasher(&_nextFilter));
+    }
+    if (_rehashCursor == _oldTable.capacity())
+    {
+        _oldTable = Table(0, _table.allocator());
+        _rehashCursor = 0;
+        _filter = std::move(_nextFilter);
+        _nextFilter = Filter(_table.allocator());
+    }
+}
+
+/**
+ * move all the buckets that are left in the old table to the table
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+void HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::_finishRehash()
+{
+    if (!_isRehashing())
+    {
+        return;
+    }
+    ResizeTimer timer(&_counters);
+    while (_rehashCursor < _oldTable.capacity())
+    {
+        _oldTable.moveBucketTo(_rehashCursor++, _table, _hasher(&_nextFilter));
+    }
+    _oldTable = Table(0, _table.allocator());
+    _rehashCursor = 0;
+    _filter = std::move(_nextFilter);
+    _nextFilter = Filter(_table.allocator());
+}
+
+/**
+ * put a filter in front of the lookups
+ * @param falsePositiveRate the false positive rate of the filter when the table is full, 0 to drop the filter
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+void HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::setFilter(double falsePositiveRate)
+{
+    _filterRate = std::min(std::max(falsePositiveRate, 0.0), 1.0);
+    _filterBitsPerKey = _filterRate == 0 ? 0 : Filter::bitsPerKeyFor(_filterRate);
+    _rebuildFilter();
+}
+
+/**
+ * build the filter again from the keys in the hash map, without the bits of the erased keys
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+void HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::_rebuildFilter()
+{
+    _finishRehash();
+    _filter = _makeFilter(capacity());
+    for (const value_type& pair : *this)
+    {
+        _filter.add(_hashOf(pair.first));
+    }
+}
+
+/**
+*
+* @param key the key that we look for is value
+* @return the value of the key in the hash map
+*/
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+const ValueT &HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::at(const KeyT &key) const
+{
+    return _valueOf(_find(key));
+}
+
+
+
+/**
+*
+* @param key the key that we look for is value
+* @return the value of the key in the hash map
+*/
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+ValueT &HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::at(const KeyT &key)
+{
+    return _valueOf(_find(key));
+}
+
+
+/**
+*
+* @param keyToFindBucket the key that we want his bucket
+* @return the size of the bucket fo the key we want
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+int HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::bucketSize(const KeyT &keyToFindBucket) const
+{
+    size_t hash = _hashOf(keyToFindBucket);
+    if(_table.find(hash, _matcher(keyToFindBucket)) != nullptr)
+    {
+        return _table.bucketSize(hash);
+    }
+    if(_isRehashing() && _oldTable.find(hash, _matcher(keyToFindBucket)) != nullptr)
+    {
+        return _oldTable.bucketSize(hash);
+    }
+    throw HashMapInvalidKeyException();
+}
+
+
+/**
+* we erase a key from the hash map
+* @param key the key that we want to erase
+* @return true if we erase, false otherwise.
+*/
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+template<class K>
+bool HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::_erase(const K &key)
+{
+    _rehashSome();
+    size_t hash = _hashOf(key);
+    if(!_filter.mayContain(hash))
+    {
+        return false;
+    }
+    if(!_table.erase(hash, _matcher(key)) &&
+       !(_isRehashing() && _oldTable.erase(hash, _matcher(key))))
+    {
+        return false;
+    }
+    _size--;
+    _changesSinceResize++;
+    _loadFactor = (double) _size / capacity();
+    if (_loadFactor < _lowerLoadFactor)
+    {
+        this->_reSize(false);
+    }
+    return true;
+}
+
+/**
+ * find a key and make an iterator that points to its pair
+ * @param key the key that we look for
+ * @return iterator to the pair of the key, end() if the key is not there
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+template<class K>
+auto HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::_findIterator(const K &key)
+{
+    size_t hash = _hashOf(key);
+    if(!_filter.mayContain(hash))
+    {
+        _counters.filterReject();
+        _counters.lookup(false);
+        return end();
+    }
+    value_type* found = _table.find(hash, _matcher(key));
+    if(found != nullptr)
+    {
+        _counters.lookup(true);
+        int start = _table.iterationStart();
+        return iterator(this, _table.runOf(hash, found, start), start, false);
+    }
+    found = _isRehashing() ? _oldTable.find(hash, _matcher(key)) : nullptr;
+    _counters.lookup(found != nullptr);
+    if(found == nullptr && _filter.enabled())
+    {
+        _counters.falsePositive();
+    }
+    if(found != nullptr)
+    {
+        int start = _oldTable.iterationStart();
+        return iterator(this, _oldTable.runOf(hash, found, start), start, true);
+    }
+    return end();
+}
+
+/**
+* clear all the hash map/
+*/
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+void HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::clear()
+{
+    _table.clear();
+    _oldTable = Table(0, _table.allocator());
+    _rehashCursor = 0;
+    _filter.clear();
+    _nextFilter = Filter(_table.allocator());
+    _size = 0;
+    _loadFactor = 0.0;
+}
+
+
+/**
+* overloading the operator []
+* @param key the key that we want is value
+* @return the value of the key in the hash map
+*/
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+ValueT &HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::operator[](const KeyT &key)
+{
+    size_t hash = _hashOf(key);
+    value_type* found = _find(hash, key);
+    if(found == nullptr)
+    {
+        found = _insertNew(hash, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>());
+    }
+    return found->second;
+}
+
+/**
+* overloading the operator []
+* @param key the key that we want is value
+* @return the value of the key in the hash map
+ */
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+const ValueT &HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::operator[](const KeyT &key) const
+{
+    return at(key);
+}
+
+/**
+* overloading the operator ==
+* @param other the other hash map that we compering to
+* @return true if this == other , false other wise.
+*/
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+bool HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::operator==(const HashMap &other) const
+{
+
+    if (_lowerLoadFactor != other._lowerLoadFactor || _size != other._size ||
+        capacity() != other.capacity() || _upperLoadFactor != other._upperLoadFactor)
+    {
+        return false;
+    }
+    for (auto& pair : *this)
+    {
+        const value_type* found = other._find(pair.first);
+        if (found == nullptr || !(found->second == pair.second))
+        {
+            return false;
+        }
+    }
+    return true;
+
+
+}
+
+/**
+* insert a pair, or assign the value to the key if it is already in the hash map
+* @param key the key that we insert, moved from if it is an rvalue
+* @param value the value that we insert or assign, moved from if it is an rvalue
+* @return true if the pair was inserted, false if the value was assigned
+*/
+template<class KeyT, class ValueT, class Storage, class Hash, class KeyEqual, class Allocator>
+template<class K, class V>
+bool HashMap<KeyT, ValueT, Storage, Hash, KeyEqual, Allocator>::insert_or_assign(K&& key, V&& value)
+{
+    size_t hash = _hashOf(key);
+    value_type* found = _find(hash, key);
+    if(found != nullptr)
+    {
+       found->second = std::forward<V>(value);
+       return false;
+    }
+    _insertNew(hash, std::forward<K>(key), std::forward<V>(value));
+    return true;
+}
+
+
+/**
+ * a HashMap whose table, pairs and keys all take their memory from one MonotonicArena: the scoped
+ * allocator passes the arena on to the ArenaString keys (and to the values that use allocators). it is
+ * constructed with an allocator_type of the arena, and it can be made with MonotonicArena::create and
+ * dropped with the arena, without destroying its pairs one by one, when its values own nothing outside
+ * the arena.
+ */
+template <class ValueT, class Storage = ChainedBuckets, class Hash = HashMapHash<ArenaString>,
+          class KeyEqual = std::equal_to<>>
+using ArenaHashMap = HashMap<ArenaString, ValueT, Storage, Hash, KeyEqual,
+                             std::scoped_allocator_adaptor<ArenaAllocator<std::pair<ArenaString, ValueT>>>>;
+
+
+#endif //EX3_HASHMAP_HPP
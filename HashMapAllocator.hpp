@@ -0,0 +1,384 @@
+#ifndef EX3_HASHMAPALLOCATOR_HPP
+#define EX3_HASHMAPALLOCATOR_HPP
+
+#include <new>
+#include <algorithm>
+#include <string>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+#define ARENA_FIRST_BLOCK 4096
+#define ARENA_MAX_BLOCK (1 << 20)
+#define POOL_BLOCKS_PER_CHUNK 256
+
+
+/// ###### monotonic arena #######
+/**
+ * this class reprasents a monotonic arena: memory is handed out from big blocks by bumping a pointer,
+ * and it is never given back one piece at a time. all of it is freed at once by release() (or by the
+ * destructor), in time of the number of blocks and not of the number of allocations.
+ * a map that takes all of its memory from an arena (its table, pairs and keys, see ArenaHashMap) can
+ * be made with create() and is then dropped with the arena without running its destructor at all.
+ */
+class MonotonicArena
+{
+private:
+
+    /** the header of a block, the memory that is handed out follows it */
+    struct Block
+    {
+        Block* next;
+        size_t size;
+    };
+
+    /** the blocks of the arena, the current one first */
+    Block* _blocks;
+
+    /** the next free byte of the current block */
+    char* _cursor;
+
+    /** the end of the current block */
+    char* _end;
+
+    /** the size of the next block, it doubles up to ARENA_MAX_BLOCK */
+    size_t _nextSize;
+
+    /** the first block size, the arena starts over with it after release() */
+    size_t _firstSize;
+
+    /**
+     * add a block that has room for at least bytes bytes aligned to align
+     * @param bytes the size of the allocation that did not fit
+     * @param align the alignment of the allocation
+     */
+    void _grow(size_t bytes, size_t align)
+    {
+        size_t size = _nextSize;
+        while (size < bytes + align + sizeof(Block))
+        {
+            size *= 2;
+        }
+        Block* block = (Block*) ::operator new(size);
+        block->next = _blocks;
+        block->size = size;
+        _blocks = block;
+        _cursor = (char*) (block + 1);
+        _end = (char*) block + size;
+        if (_nextSize < ARENA_MAX_BLOCK)
+        {
+            _nextSize *= 2;
+        }
+    }
+
+public:
+
+    /**
+     * Construct an empty arena, no memory is taken until the first allocation
+     * @param firstBlock the size of the first block in bytes
+     */
+    explicit MonotonicArena(size_t firstBlock = ARENA_FIRST_BLOCK) : _blocks(nullptr), _cursor(nullptr),
+                                                                     _end(nullptr), _nextSize(firstBlock),
+                                                                     _firstSize(firstBlock) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    /**
+     * free all the blocks
+     */
+    ~MonotonicArena() { release(); }
+
+    /**
+     * @param bytes the number of bytes
+     * @param align the alignment, a power of 2
+     * @return memory for the bytes, it stays valid until release()
+     */
+    void* allocate(size_t bytes, size_t align)
+    {
+        size_t padding = (size_t) (-(uintptr_t) _cursor) & (align - 1);
+        if (_cursor == nullptr || (size_t) (_end - _cursor) < padding + bytes)
+        {
+            _grow(bytes, align);
+            padding = (size_t) (-(uintptr_t) _cursor) & (align - 1);
+        }
+        void* memory = _cursor + padding;
+        _cursor += padding + bytes;
+        return memory;
+    }
+
+    /**
+     * free all the memory of the arena at once, nothing that was allocated from it may be used after
+     * that. no destructor is run.
+     */
+    void release()
+    {
+        while (_blocks != nullptr)
+        {
+            Block* next = _blocks->next;
+            ::operator delete(_blocks);
+            _blocks = next;
+        }
+        _cursor = nullptr;
+        _end = nullptr;
+        _nextSize = _firstSize;
+    }
+
+    /**
+     * construct an object in the arena. it is never destroyed, so it must not own anything that is not
+     * in the arena, and it is gone after release()
+     * @param args the args that the object is constructed from
+     * @return pointer to the object
+     */
+    template <class T, class... Args>
+    T* create(Args&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+};
+
+/**
+ * an allocator that takes its memory from a MonotonicArena. deallocate does nothing, the memory is
+ * freed with the arena. the allocator moves with the container, so moving a container never copies its
+ * elements.
+ * @tparam T the type that is allocated
+ */
+template <class T>
+class ArenaAllocator
+{
+private:
+
+    template <class U>
+    friend class ArenaAllocator;
+
+    /** the arena of the allocator */
+    MonotonicArena* _arena;
+
+public:
+
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    /**
+     * @param arena the arena that the memory is taken from
+     */
+    ArenaAllocator(MonotonicArena& arena) : _arena(&arena) {}
+
+    /**
+     * the same arena, for another type
+     * @param other an allocator of the arena
+     */
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other._arena) {}
+
+    T* allocate(size_t n) { return (T*) _arena->allocate(n * sizeof(T), alignof(T)); }
+
+    void deallocate(T*, size_t) {}
+
+    /**
+     *
+     * @return the arena of the allocator
+     */
+    MonotonicArena& arena() const { return *_arena; }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const { return _arena == other._arena; }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return _arena != other._arena; }
+};
+
+/** a string whose chars are in an arena, the key of an ArenaHashMap */
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+/// ### end of monotonic arena ###///
+
+
+/// ###### fixed size pool #######
+/**
+ * this class reprasents a pool of blocks of one size. a freed block goes to a free list and is handed
+ * out again by the next allocation, so a map that keeps erasing and inserting small buckets or keys does
+ * not call malloc and free for them. the blocks are carved from chunks that are freed all at once when
+ * the pool is destroyed.
+ */
+class FixedPool
+{
+private:
+
+    /** a free block holds the next free block */
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    /** the size of a block, a multiple of alignof(std::max_align_t) */
+    size_t _blockSize;
+
+    /** the free blocks */
+    FreeBlock* _free;
+
+    /** the chunks of the pool, every chunk starts with the pointer to the next one */
+    void* _chunks;
+
+public:
+
+    /**
+     * @param blockSize the size of the blocks in bytes
+     */
+    explicit FixedPool(size_t blockSize) :
+            _blockSize((std::max(blockSize, sizeof(FreeBlock)) + alignof(std::max_align_t) - 1) &
+                       ~(alignof(std::max_align_t) - 1)), _free(nullptr), _chunks(nullptr) {}
+
+    FixedPool(const FixedPool&) = delete;
+
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    /**
+     * free all the chunks
+     */
+    ~FixedPool()
+    {
+        while (_chunks != nullptr)
+        {
+            void* next = *(void**) _chunks;
+            ::operator delete(_chunks);
+            _chunks = next;
+        }
+    }
+
+    /**
+     *
+     * @return the size of the blocks of the pool
+     */
+    size_t blockSize() const { return _blockSize; }
+
+    /**
+     *
+     * @return a block of blockSize() bytes, aligned to alignof(std::max_align_t)
+     */
+    void* allocate()
+    {
+        if (_free == nullptr)
+        {
+            // the first block of a chunk holds the link to the next chunk
+            char* chunk = (char*) ::operator new(_blockSize * (POOL_BLOCKS_PER_CHUNK + 1));
+            *(void**) chunk = _chunks;
+            _chunks = chunk;
+            for (size_t i = POOL_BLOCKS_PER_CHUNK; i > 0; i--)
+            {
+                FreeBlock* block = (FreeBlock*) (chunk + i * _blockSize);
+                block->next = _free;
+                _free = block;
+            }
+        }
+        FreeBlock* block = _free;
+        _free = block->next;
+        return block;
+    }
+
+    /**
+     * @param block a block of this pool, it goes back to the free list
+     */
+    void deallocate(void* block)
+    {
+        FreeBlock* freed = (FreeBlock*) block;
+        freed->next = _free;
+        _free = freed;
+    }
+};
+
+/**
+ * an allocator that takes the allocations that fit in a block from a FixedPool, and the bigger ones
+ * (like the bucket array of a map) from operator new. it is not thread safe, like the pool.
+ * @tparam T the type that is allocated
+ */
+template <class T>
+class PoolAllocator
+{
+private:
+
+    template <class U>
+    friend class PoolAllocator;
+
+    /** the pool of the allocator */
+    FixedPool* _pool;
+
+    /**
+     * @param n the number of objects
+     * @return true if n objects are allocated from the pool
+     */
+    bool _fits(size_t n) const
+    {
+        return n * sizeof(T) <= _pool->blockSize() && alignof(T) <= alignof(std::max_align_t);
+    }
+
+public:
+
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    /**
+     * @param pool the pool that the small allocations are taken from
+     */
+    PoolAllocator(FixedPool& pool) : _pool(&pool) {}
+
+    /**
+     * the same pool, for another type
+     * @param other an allocator of the pool
+     */
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>& other) : _pool(other._pool) {}
+
+    T* allocate(size_t n)
+    {
+        if (_fits(n))
+        {
+            return (T*) _pool->allocate();
+        }
+        // an over aligned type (like the blocks of a filter) needs the aligned operator new
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return (T*) ::operator new(n * sizeof(T), std::align_val_t(alignof(T)));
+        }
+        else
+        {
+            return (T*) ::operator new(n * sizeof(T));
+        }
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if (_fits(n))
+        {
+            _pool->deallocate(p);
+            return;
+        }
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        }
+        else
+        {
+            ::operator delete(p);
+        }
+    }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U>& other) const { return _pool == other._pool; }
+
+    template <class U>
+    bool operator!=(const PoolAllocator<U>& other) const { return _pool != other._pool; }
+};
+
+/// ### end of fixed size pool ###///
+
+
+#endif //EX3_HASHMAPALLOCATOR_HPP
@@ -0,0 +1,234 @@
+#ifndef EX3_HASHMAPFILTER_HPP
+#define EX3_HASHMAPFILTER_HPP
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+
+#define FILTER_WORDS 8
+#define FILTER_WORD_BITS 32
+#define FILTER_BLOCK_BITS (FILTER_WORDS * FILTER_WORD_BITS)
+#define FILTER_BIT_INDEX_BITS 5
+#define FILTER_MIN_BITS_PER_KEY 2.0
+#define FILTER_MAX_BITS_PER_KEY 64.0
+
+
+/// ###### filter #######
+/**
+ * a split block Bloom filter of the hashes of the keys of a HashMap. a block is 8 words of 32 bits (half a
+ * cache line) and a key sets one bit in every word of the block its hash picks, so a lookup of a key that is
+ * not in the map reads one cache line of the filter and usually never touches the table.
+ * a bit cannot be cleared, so an erased key may still pass the filter until it is built again. a filter with
+ * no blocks is off, it passes every key and adding to it does nothing.
+ * @tparam Allocator the allocator of the HashMap, rebound to the blocks
+ */
+template <class Allocator>
+class HashMapFilter
+{
+private:
+
+    /** the bits of the keys whose hash picks the block */
+    struct alignas(FILTER_BLOCK_BITS / 8) Block
+    {
+        uint32_t words[FILTER_WORDS];
+    };
+
+    using BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+
+    std::vector<Block, BlockAllocator> _blocks;
+
+    /** the number of keys the filter was sized for */
+    size_t _capacity;
+
+    /** the number of keys that were added since the filter was built */
+    size_t _added;
+
+    /** odd numbers that spread the low half of the hash over the bits of every word, as in the split block
+     * Bloom filters of Parquet */
+    static constexpr uint32_t SALTS[FILTER_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                     0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+    /**
+     * @param hash the hash of a key
+     * @return the block of the key, picked by the high half of the hash since the table uses the low bits
+     */
+    size_t _blockIndex(size_t hash) const
+    {
+        return (size_t) (((uint64_t) hash >> 32) * _blocks.size() >> 32);
+    }
+
+    /**
+     * the bits of the words are picked by the low half of the hash of the key only, every word multiplies it by
+     * its own salt and takes the top 5 bits. the high half picks the block, and the HashMap mixes the hash
+     * well, so the bits are independent of the block
+     * @param hash the hash of a key
+     * @param word the index of a word of the block
+     * @return the bit of the key in the word
+     */
+    static uint32_t _bit(size_t hash, int word)
+    {
+        return (uint32_t) 1 << ((uint32_t) hash * SALTS[word] >> (FILTER_WORD_BITS - FILTER_BIT_INDEX_BITS));
+    }
+
+public:
+
+    /**
+     * a filter that is off
+     * @param allocator the allocator of the blocks
+     */
+    explicit HashMapFilter(const Allocator& allocator) : _blocks(BlockAllocator(allocator)), _capacity(0), _added(0)
+    {
+    }
+
+    /**
+     * an empty filter
+     * @param keys the number of keys the filter is sized for
+     * @param bitsPerKey the bits of the filter for every key, see bitsPerKeyFor
+     * @param allocator the allocator of the blocks
+     */
+    HashMapFilter(size_t keys, double bitsPerKey, const Allocator& allocator) :
+            _blocks(std::max((size_t) std::ceil((double) keys * bitsPerKey / FILTER_BLOCK_BITS), (size_t) 1),
+                    Block{}, BlockAllocator(allocator)), _capacity(keys), _added(0)
+    {
+    }
+
+    /**
+     *
+     * @return true if the filter is on
+     */
+    bool enabled() const { return !_blocks.empty(); }
+
+    /**
+     *
+     * @return true if the filter got twice the keys it was sized for, so erased keys fill it up and it should
+     * be built again from the keys that are left
+     */
+    bool overfull() const { return _added > 2 * _capacity; }
+
+    /**
+     * @param hash the hash of a key that is added to the map
+     */
+    void add(size_t hash)
+    {
+        if (_blocks.empty())
+        {
+            return;
+        }
+        Block& block = _blocks[_blockIndex(hash)];
+        for (int word = 0; word < FILTER_WORDS; word++)
+        {
+            block.words[word] |= _bit(hash, word);
+        }
+        _added++;
+    }
+
+    /**
+     * @param hash the hash of a key
+     * @return false only if the key is not in the map
+     */
+    bool mayContain(size_t hash) const
+    {
+        if (_blocks.empty())
+        {
+            return true;
+        }
+        const Block& block = _blocks[_blockIndex(hash)];
+        // no branch per word, a key that is not there is usually missing from a few of them
+        uint32_t missing = 0;
+        for (int word = 0; word < FILTER_WORDS; word++)
+        {
+            missing |= _bit(hash, word) & ~block.words[word];
+        }
+        return missing == 0;
+    }
+
+    /**
+     * forget all the keys, the size stays
+     */
+    void clear()
+    {
+        std::fill(_blocks.begin(), _blocks.end(), Block{});
+        _added = 0;
+    }
+
+    /**
+     *
+     * @return the bytes of the filter
+     */
+    size_t bytes() const { return _blocks.capacity() * sizeof(Block); }
+
+    /**
+     * the rate from the bits that are set: the chance that the block of a key that is not in the map has the
+     * bits of the key in all its words. it counts the bits of erased keys too, and takes time of the blocks
+     * @return the false positive rate of the filter as it is now, 1 if it is off
+     */
+    double falsePositiveRate() const
+    {
+        if (_blocks.empty())
+        {
+            return 1;
+        }
+        double sum = 0;
+        for (const Block& block : _blocks)
+        {
+            double rate = 1;
+            for (uint32_t word : block.words)
+            {
+                rate *= (double) __builtin_popcount(word) / FILTER_WORD_BITS;
+            }
+            sum += rate;
+        }
+        return sum / (double) _blocks.size();
+    }
+
+    /**
+     * the expected false positive rate of a full filter: the keys of a block are poisson distributed, and a
+     * block of i keys has a bit of a word set with the chance 1 - (31/32)^i
+     * @param bitsPerKey the bits of the filter for every key
+     * @return the false positive rate when the filter has as many keys as it was sized for
+     */
+    static double expectedRate(double bitsPerKey)
+    {
+        double keysPerBlock = FILTER_BLOCK_BITS / bitsPerKey;
+        double poisson = std::exp(-keysPerBlock);
+        double rate = 0;
+        int last = (int) (keysPerBlock + 12 * std::sqrt(keysPerBlock) + 20);
+        for (int keys = 0; keys <= last; keys++)
+        {
+            double set = 1 - std::pow(1 - 1.0 / FILTER_WORD_BITS, keys);
+            rate += poisson * std::pow(set, FILTER_WORDS);
+            poisson *= keysPerBlock / (keys + 1);
+        }
+        return rate;
+    }
+
+    /**
+     * @param rate the wanted false positive rate
+     * @return the fewest bits per key that keep a full filter at the rate, between FILTER_MIN_BITS_PER_KEY and
+     * FILTER_MAX_BITS_PER_KEY
+     */
+    static double bitsPerKeyFor(double rate)
+    {
+        double low = FILTER_MIN_BITS_PER_KEY;
+        double high = FILTER_MAX_BITS_PER_KEY;
+        if (expectedRate(low) <= rate)
+        {
+            return low;
+        }
+        for (int i = 0; i < 40; i++)
+        {
+            double middle = (low + high) / 2;
+            (expectedRate(middle) <= rate ? high : low) = middle;
+        }
+        return high;
+    }
+};
+
+/// ### end of filter ###///
+
+
+#endif //EX3_HASHMAPFILTER_HPP
@@ -0,0 +1,225 @@
+#ifndef EX3_HASHMAPHASH_HPP
+#define EX3_HASHMAPHASH_HPP
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+/// ###### hash functions #######
+/**
+ * the hash function of the HashMap, std::hash of the key
+ * @tparam KeyT the type key of the hash map
+ */
+template <class KeyT>
+struct HashMapHash : std::hash<KeyT>
+{
+};
+
+/**
+ * the hash function of a HashMap with std::string keys. it is transparent: a std::string_view or a
+ * const char* has the same hash as the std::string with the same chars, so the map can be queried
+ * with them without allocating a std::string.
+ */
+template <>
+struct HashMapHash<std::string>
+{
+    using is_transparent = void;
+
+    /**
+     * @param key the chars of the key
+     * @return the hash of the key
+     */
+    size_t operator()(std::string_view key) const { return std::hash<std::string_view>()(key); }
+};
+
+/**
+ * the hash function of a HashMap with string keys of another allocator (like an ArenaString), the
+ * same as the one of std::string, so the keys can be looked up with a std::string_view
+ * @tparam Allocator the allocator of the key
+ */
+template <class Allocator>
+struct HashMapHash<std::basic_string<char, std::char_traits<char>, Allocator>> : HashMapHash<std::string>
+{
+};
+
+/**
+ * multiply two 64 bit numbers
+ * @param a the first number, gets the low 64 bits of the product
+ * @param b the second number, gets the high 64 bits of the product
+ */
+inline void hashMultiply(uint64_t* a, uint64_t* b)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t) *a * *b;
+    *a = (uint64_t) product;
+    *b = (uint64_t) (product >> 64);
+#else
+    uint64_t aHigh = *a >> 32, aLow = (uint32_t) *a, bHigh = *b >> 32, bLow = (uint32_t) *b;
+    uint64_t highHigh = aHigh * bHigh, highLow = aHigh * bLow, lowHigh = aLow * bHigh, lowLow = aLow * bLow;
+    uint64_t middle = (lowLow >> 32) + (uint32_t) highLow + (uint32_t) lowHigh;
+    *a = (middle << 32) | (uint32_t) lowLow;
+    *b = highHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+#endif
+}
+
+/**
+ * fold the full 128 bit product of two 64 bit numbers into 64 bits
+ * @return the low half of the product xor its high half
+ */
+inline uint64_t hashMix(uint64_t a, uint64_t b)
+{
+    hashMultiply(&a, &b);
+    return a ^ b;
+}
+
+/**
+ * spread the bits of a hash, so every bit of it affects the low bits that pick the bucket.
+ * std::hash of an integer is the integer itself and std::hash of a string leaves patterns in its
+ * low bits, so masking them with capacity - 1 without mixing fills a few buckets only.
+ * @param hash the hash that a hash function returned
+ * @return the mixed hash
+ */
+inline size_t hashIndexMix(size_t hash)
+{
+    return (size_t) hashMix((uint64_t) hash, 0x9e3779b97f4a7c15ull);
+}
+
+/**
+ * a fast string hash function in the style of wyhash: the string is read 8 and 16 bytes at a time
+ * and every block goes through a single 64x64->128 bit multiplication. its output is already well
+ * mixed, so the HashMap uses it as is (is_avalanching), and it is transparent like
+ * HashMapHash<std::string>.
+ */
+struct FastStringHash
+{
+    using is_transparent = void;
+    using is_avalanching = void;
+
+    /**
+     * @param key the chars of the key
+     * @return the hash of the key
+     */
+    size_t operator()(std::string_view key) const { return (size_t) hash(key.data(), key.size(), 0); }
+
+    /**
+     * @param data the bytes we hash
+     * @param length the number of bytes
+     * @param seed a seed that changes the hash
+     * @return the 64 bit hash of the bytes
+     */
+    static uint64_t hash(const char* data, size_t length, uint64_t seed)
+    {
+        const uint64_t secret0 = 0xa0761d6478bd642full, secret1 = 0xe7037ed1a0b428dbull;
+        const uint64_t secret2 = 0x8ebc6af09c88c6e3ull, secret3 = 0x589965cc75374cc3ull;
+        const unsigned char* p = (const unsigned char*) data;
+        uint64_t a, b;
+        seed ^= hashMix(seed ^ secret0, secret1);
+        if (length <= 16)
+        {
+            if (length >= 4)
+            {
+                a = (_read4(p) << 32) | _read4(p + ((length >> 3) << 2));
+                b = (_read4(p + length - 4) << 32) | _read4(p + length - 4 - ((length >> 3) << 2));
+            }
+            else if (length > 0)
+            {
+                a = ((uint64_t) p[0] << 16) | ((uint64_t) p[length >> 1] << 8) | p[length - 1];
+                b = 0;
+            }
+            else
+            {
+                a = b = 0;
+            }
+        }
+        else
+        {
+            size_t left = length;
+            if (left > 48)
+            {
+                uint64_t seed1 = seed, seed2 = seed;
+                do
+                {
+                    seed = hashMix(_read8(p) ^ secret1, _read8(p + 8) ^ seed);
+                    seed1 = hashMix(_read8(p + 16) ^ secret2, _read8(p + 24) ^ seed1);
+                    seed2 = hashMix(_read8(p + 32) ^ secret3, _read8(p + 40) ^ seed2);
+                    p += 48;
+                    left -= 48;
+                } while (left > 48);
+                seed ^= seed1 ^ seed2;
+            }
+            while (left > 16)
+            {
+                seed = hashMix(_read8(p) ^ secret1, _read8(p + 8) ^ seed);
+                p += 16;
+                left -= 16;
+            }
+            a = _read8(p + left - 16);
+            b = _read8(p + left - 8);
+        }
+        a ^= secret1;
+        b ^= seed;
+        hashMultiply(&a, &b);
+        return hashMix(a ^ secret0 ^ length, b ^ secret1);
+    }
+
+private:
+
+    /**
+     * @param p pointer to 8 bytes
+     * @return the bytes as a little endian number
+     */
+    static uint64_t _read8(const unsigned char* p)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @param p pointer to 4 bytes
+     * @return the bytes as a little endian number
+     */
+    static uint64_t _read4(const unsigned char* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+};
+
+/**
+ * tells if a hash function mixes its output well enough to mask it with capacity - 1 as is
+ * @tparam Hash the hash function
+ */
+template <class Hash, class = void>
+struct IsAvalanching : std::false_type
+{
+};
+
+/**
+ * a hash function that declares is_avalanching mixes its output well enough
+ * @tparam Hash the hash function
+ */
+template <class Hash>
+struct IsAvalanching<Hash, std::void_t<typename Hash::is_avalanching>> : std::true_type
+{
+};
+
+/**
+ * tells if a hash function and a key equality can be called with a key of another type than KeyT,
+ * only then the HashMap offers the lookups that take another type of key
+ * @tparam Hash the hash function
+ * @tparam KeyEqual the key equality
+ */
+template <class Hash, class KeyEqual>
+using IsTransparent = std::void_t<typename Hash::is_transparent, typename KeyEqual::is_transparent>;
+
+/// ### end of hash functions ###///
+
+
+#endif //EX3_HASHMAPHASH_HPP
@@ -0,0 +1,297 @@
+#ifndef EX3_HASHMAPSTATS_HPP
+#define EX3_HASHMAPSTATS_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <cstddef>
+
+
+// build with -DHASHMAP_STATS=1 to count the lookups and the time spent resizing. the counters are on the hot
+// path, so they are off by default and cost nothing then. the whole program must be built with the same value.
+#ifndef HASHMAP_STATS
+#define HASHMAP_STATS 0
+#endif
+
+#define STATS_MAX_BUCKET_LENGTH 16
+
+
+/// ###### stats #######
+/**
+ * the stats of a HashMap, see HashMap::stats(). the shape of the table (the bucket lengths, the probe
+ * lengths, the bytes) and the resize counts are always there, the lookups and the resize time only when
+ * the HashMap is built with HASHMAP_STATS.
+ */
+struct HashMapStats
+{
+    /**
+     * bucketLengths[i] is the number of buckets with i pairs, the last one counts the longer buckets too.
+     * a bucket of the OpenAddressing policy is the pairs whose home slot is the same slot
+     */
+    std::vector<long> bucketLengths = std::vector<long>(STATS_MAX_BUCKET_LENGTH + 1, 0);
+
+    /** number of buckets */
+    long buckets = 0;
+
+    /** number of pairs */
+    long pairs = 0;
+
+    /** the sum of the probe lengths of all the pairs, the pairs a lookup of the key goes over */
+    long probeSum = 0;
+
+    /** the longest probe length */
+    int maxProbe = 0;
+
+    /** true if the lookups and the resize time were counted */
+    bool counted = HASHMAP_STATS != 0;
+
+    /** number of lookups that found the key */
+    long hits = 0;
+
+    /** number of lookups that did not find the key */
+    long misses = 0;
+
+    /** number of times the table grew */
+    long grows = 0;
+
+    /** number of times the table shrank */
+    long shrinks = 0;
+
+    /** the time spent moving pairs to a new table, the steps of an incremental rehash too */
+    double resizeSeconds = 0;
+
+    /** the bytes that the table holds, without the memory that the keys and values own */
+    size_t bytes = 0;
+
+    /** the bytes of the filter, 0 when the HashMap has no filter */
+    size_t filterBytes = 0;
+
+    /** the false positive rate that the filter was asked for */
+    double filterTargetRate = 0;
+
+    /** the false positive rate of the filter from the bits that are set in it */
+    double filterRate = 0;
+
+    /** number of lookups that the filter answered without the table */
+    long filterRejects = 0;
+
+    /** number of lookups that passed the filter and did not find the key */
+    long falsePositives = 0;
+
+    /**
+     * count a bucket
+     * @param length the number of pairs in the bucket
+     */
+    void addBucket(int length)
+    {
+        bucketLengths[length < STATS_MAX_BUCKET_LENGTH ? length : STATS_MAX_BUCKET_LENGTH]++;
+        buckets++;
+    }
+
+    /**
+     * count a pair
+     * @param length the probe length of the pair, 1 if a lookup finds it first
+     */
+    void addProbe(int length)
+    {
+        pairs++;
+        probeSum += length;
+        maxProbe = length > maxProbe ? length : maxProbe;
+    }
+
+    /**
+     *
+     * @return the average probe length of a lookup that finds its key
+     */
+    double averageProbe() const { return pairs == 0 ? 0 : (double) probeSum / (double) pairs; }
+
+    /**
+     * print the stats, one line for every kind
+     * @param out the stream we print to
+     */
+    void print(std::ostream& out) const
+    {
+        out << std::fixed << std::setprecision(3);
+        out << "pairs: " << pairs << ", buckets: " << buckets << ", load factor: "
+            << (buckets == 0 ? 0 : (double) pairs / (double) buckets) << '\n';
+        out << "bucket lengths:";
+        for (size_t length = 0; length < bucketLengths.size(); length++)
+        {
+            if (bucketLengths[length] != 0)
+            {
+                out << ' ' << length << (length == STATS_MAX_BUCKET_LENGTH ? "+" : "") << ':'
+                    << bucketLengths[length];
+            }
+        }
+        out << '\n';
+        out << "probe length: average " << averageProbe() << ", max " << maxProbe << '\n';
+        if (counted)
+        {
+            out << "lookups: " << hits << " hits, " << misses << " misses\n";
+        }
+        else
+        {
+            out << "lookups: not counted, build with -DHASHMAP_STATS=1\n";
+        }
+        out << "resizes: " << grows << " grows, " << shrinks << " shrinks";
+        if (counted)
+        {
+            out << ", " << resizeSeconds * 1000 << " ms";
+        }
+        out << '\n';
+        if (filterBytes != 0)
+        {
+            out << "filter: " << filterBytes << " bytes, target rate " << filterTargetRate << ", estimated rate "
+                << filterRate;
+            if (counted)
+            {
+                long passed = filterRejects + falsePositives;
+                out << ", " << filterRejects << " rejects, " << falsePositives << " false positives (rate "
+                    << (passed == 0 ? 0 : (double) falsePositives / (double) passed) << ")";
+            }
+            out << '\n';
+        }
+        out << "bytes: " << bytes << std::endl;
+    }
+};
+
+/**
+ * the counters of the hot path of a HashMap, they are only kept when Enabled (HASHMAP_STATS). a const
+ * lookup counts too, so the lookup counters are relaxed atomics, and readers of a HashMap can still share it
+ * between threads. the resize time is only counted by changes of the map, like the map itself.
+ * @tparam Enabled true to count
+ */
+template <bool Enabled>
+class HashMapCounters
+{
+private:
+
+    using Clock = std::chrono::steady_clock;
+
+    std::atomic<long> _hits{0};
+
+    std::atomic<long> _misses{0};
+
+    double _resizeSeconds = 0;
+
+    std::atomic<long> _filterRejects{0};
+
+    std::atomic<long> _falsePositives{0};
+
+    /** number of resize timers that run, only the outer one counts */
+    int _timing = 0;
+
+    /**
+     * copy the counts of other
+     * @param other the counters of the map that is copied
+     */
+    void _assign(const HashMapCounters& other)
+    {
+        _hits.store(other._hits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _misses.store(other._misses.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _resizeSeconds = other._resizeSeconds;
+        _filterRejects.store(other._filterRejects.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _falsePositives.store(other._falsePositives.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+public:
+
+    HashMapCounters() = default;
+
+    HashMapCounters(const HashMapCounters& other) { _assign(other); }
+
+    HashMapCounters& operator=(const HashMapCounters& other)
+    {
+        _assign(other);
+        return *this;
+    }
+
+    /** measures a resize from its construction to its destruction */
+    class Timer
+    {
+    private:
+
+        HashMapCounters* _counters;
+
+        Clock::time_point _start;
+
+    public:
+
+        explicit Timer(HashMapCounters* counters) : _counters(counters), _start(Clock::now()) { _counters->_timing++; }
+
+        Timer(const Timer&) = delete;
+
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer()
+        {
+            if (--_counters->_timing == 0)
+            {
+                _counters->_resizeSeconds += std::chrono::duration<double>(Clock::now() - _start).count();
+            }
+        }
+    };
+
+    /**
+     * count a lookup
+     * @param found true if the lookup found the key
+     */
+    void lookup(bool found)
+    {
+        (found ? _hits : _misses).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * count a lookup that the filter answered, lookup(false) counts it as a miss too
+     */
+    void filterReject() { _filterRejects.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * count a lookup that passed the filter and did not find the key
+     */
+    void falsePositive() { _falsePositives.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * add the counters to stats
+     * @param stats the stats
+     */
+    void collect(HashMapStats* stats) const
+    {
+        stats->hits = _hits.load(std::memory_order_relaxed);
+        stats->misses = _misses.load(std::memory_order_relaxed);
+        stats->resizeSeconds = _resizeSeconds;
+        stats->filterRejects = _filterRejects.load(std::memory_order_relaxed);
+        stats->falsePositives = _falsePositives.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * the counters when the stats are off, they do nothing
+ */
+template <>
+class HashMapCounters<false>
+{
+public:
+
+    class Timer
+    {
+    public:
+
+        explicit Timer(HashMapCounters*) {}
+    };
+
+    void lookup(bool) {}
+
+    void filterReject() {}
+
+    void falsePositive() {}
+
+    void collect(HashMapStats*) const {}
+};
+
+/// ### end of stats ###///
+
+
+#endif //EX3_HASHMAPSTATS_HPP
@@ -0,0 +1,827 @@
+#ifndef EX3_HASHMAPSTORAGE_HPP
+#define EX3_HASHMAPSTORAGE_HPP
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include "HashMapStats.hpp"
+
+
+/// ###### storage policies #######
+/**
+ * a run of pairs that are next to each other in the memory of a table: a bucket of the ChainedBuckets
+ * policy, or consecutive occupied slots of the OpenAddressing policy. the iterators of the HashMap walk
+ * a table run by run, and inside a run they only increment a pointer.
+ * @tparam T the type of the pairs
+ */
+template <class T>
+struct TableRun
+{
+    /** the first pair of the run, nullptr when there are no more runs */
+    T* first;
+
+    /** past the last pair of the run */
+    T* last;
+
+    /** the position of the run in the iteration order of the table */
+    int position;
+
+    /** the position that the next run is looked for from */
+    int next;
+};
+
+/**
+ * storage policy of the HashMap that keeps every bucket as its own vector of pairs (separate
+ * chaining). this is the default policy of the HashMap.
+ */
+struct ChainedBuckets
+{
+    template <class KeyT, class ValueT, class Allocator = std::allocator<std::pair<KeyT, ValueT>>>
+    class Table;
+};
+
+/**
+ * storage policy of the HashMap that keeps all the pairs in one contiguous slot array, using
+ * Robin Hood open addressing. a lookup walks neighbouring slots instead of chasing a pointer to a
+ * separately allocated bucket, so it usually costs a single cache miss.
+ */
+struct OpenAddressing
+{
+    template <class KeyT, class ValueT, class Allocator = std::allocator<std::pair<KeyT, ValueT>>>
+    class Table;
+};
+
+
+/**
+ * the table of the ChainedBuckets policy, a vector of buckets where each bucket is a vector of
+ * pairs.
+ * every table of a storage policy exposes the same interface that the HashMap uses:
+ * find, insertUnique, erase, bucketSize, clear, rehash / moveBucketTo for the resize, and
+ * iterationStart / nextRun / runOf / eraseInRun for the iteration, and collectStats.
+ * the tables get the hash of the key from the HashMap, and the keys are compared through the
+ * given matches predicate, so a table knows nothing about the hash function or the key equality.
+ * every table allocates all of its memory through the allocator it gets (rebound to what it
+ * allocates), and constructs the pairs through it, so a scoped_allocator_adaptor passes it on to the
+ * keys and the values.
+ * @tparam KeyT the type key of the hash map
+ * @tparam ValueT the type of the value in the hash map
+ * @tparam Allocator the allocator of the pairs
+ */
+template <class KeyT, class ValueT, class Allocator>
+class ChainedBuckets::Table
+{
+public:
+
+    using value_type = std::pair<KeyT, ValueT>;
+
+private:
+
+    using PairAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+
+    using Bucket = std::vector<value_type, PairAllocator>;
+
+    using BucketAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Bucket>;
+
+    using WordAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<uint64_t>;
+
+    /** vetor of buckets , represents the hash table*/
+    std::vector<Bucket, BucketAllocator> _buckets;
+
+    /** a bit for every bucket that is not empty, so an iteration skips 64 empty buckets at a time */
+    std::vector<uint64_t, WordAllocator> _occupied;
+
+    /**
+     * @param hash the hash of the key
+     * @return the bucket that the hash is mapped to
+     */
+    size_t _bucketIndex(size_t hash) const { return hash & (_buckets.size() - 1); }
+
+    /**
+     * @param bucket index of a bucket that is not empty
+     */
+    void _markOccupied(size_t bucket) { _occupied[bucket >> 6] |= (uint64_t) 1 << (bucket & 63); }
+
+    /**
+     * @param bucket index of a bucket that is empty
+     */
+    void _markEmpty(size_t bucket) { _occupied[bucket >> 6] &= ~((uint64_t) 1 << (bucket & 63)); }
+
+public:
+
+    /**
+     * @param capacity the number of buckets in the table, must be a power of 2
+     * @param allocator the allocator of the buckets and the pairs
+     */
+    explicit Table(int capacity, const Allocator& allocator = Allocator()) :
+            _buckets((size_t) capacity, Bucket(PairAllocator(allocator)), BucketAllocator(allocator)),
+            _occupied(((size_t) capacity + 63) / 64, 0, WordAllocator(allocator)) {}
+
+    /**
+     *
+     * @return the number of buckets in the table
+     */
+    int capacity() const { return (int) _buckets.size(); }
+
+    /**
+     * add the bucket lengths, the probe lengths and the bytes of the table to stats. the probe length of
+     * a pair is its place in its bucket
+     * @param stats the stats
+     */
+    void collectStats(HashMapStats* stats) const
+    {
+        for (const auto& bucket : _buckets)
+        {
+            stats->addBucket((int) bucket.size());
+            for (int probe = 1; probe <= (int) bucket.size(); probe++)
+            {
+                stats->addProbe(probe);
+            }
+            stats->bytes += bucket.capacity() * sizeof(value_type);
+        }
+        stats->bytes += _buckets.capacity() * sizeof(Bucket) + _occupied.capacity() * sizeof(uint64_t);
+    }
+
+    /**
+     *
+     * @return the allocator of the table
+     */
+    Allocator allocator() const { return Allocator(_buckets.get_allocator()); }
+
+    /**
+     * find a pair in the table
+     * @param hash the hash of the key we look for
+     * @param matches predicate that gets a key and returns true if it is the key we look for
+     * @return pointer to the pair of the key, nullptr if the key is not in the table
+     */
+    template <class Matches>
+    value_type* find(size_t hash, Matches matches)
+    {
+        for (auto& pair : _buckets[_bucketIndex(hash)])
+        {
+            if (matches(pair.first))
+            {
+                return &pair;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * find a pair in the table
+     * @param hash the hash of the key we look for
+     * @param matches predicate that gets a key and returns true if it is the key we look for
+     * @return pointer to the pair of the key, nullptr if the key is not in the table
+     */
+    template <class Matches>
+    const value_type* find(size_t hash, Matches matches) const
+    {
+        return const_cast<Table*>(this)->find(hash, matches);
+    }
+
+    /**
+     * insert a pair to the table, the caller is responsible that the key is not in the table
+     * @param hash the hash of the key
+     * @param args the args that the pair is constructed from
+     * @return pointer to the new pair, nullptr if there is no room for it in the table
+     */
+    template <class... Args>
+    value_type* insertUnique(size_t hash, Args&&... args)
+    {
+        size_t index = _bucketIndex(hash);
+        Bucket& bucket = _buckets[index];
+        bucket.emplace_back(std::forward<Args>(args)...);
+        _markOccupied(index);
+        return &bucket.back();
+    }
+
+    /**
+     * erase a pair from the table
+     * @param hash the hash of the key we erase
+     * @param matches predicate that gets a key and returns true if it is the key we erase
+     * @return true if we erase, false if the key is not in the table
+     */
+    template <class Matches>
+    bool erase(size_t hash, Matches matches)
+    {
+        value_type* found = find(hash, matches);
+        if (found == nullptr)
+        {
+            return false;
+        }
+        _eraseFrom(_bucketIndex(hash), found);
+        return true;
+    }
+
+    /**
+     * @param hash the hash of a key
+     * @return the number of pairs in the bucket the hash is mapped to
+     */
+    int bucketSize(size_t hash) const { return (int) _buckets[_bucketIndex(hash)].size(); }
+
+    /**
+     * clear all the pairs from the table, the number of buckets stays the same
+     */
+    void clear()
+    {
+        for (auto& bucket : _buckets)
+        {
+            bucket.clear();
+        }
+        std::fill(_occupied.begin(), _occupied.end(), 0);
+    }
+
+    /**
+     * change the number of buckets of the table, the pairs are moved to their new buckets without
+     * copying them and without checking for duplicates
+     * @param capacity the new number of buckets, must be a power of 2
+     * @param hasher function that returns the hash of a key
+     */
+    template <class Hasher>
+    void rehash(int capacity, Hasher hasher)
+    {
+        std::vector<Bucket, BucketAllocator> oldBuckets((size_t) capacity, Bucket(PairAllocator(allocator())),
+                                                        _buckets.get_allocator());
+        std::swap(oldBuckets, _buckets);
+        _occupied.assign(((size_t) capacity + 63) / 64, 0);
+        for (auto& bucket : oldBuckets)
+        {
+            for (auto& pair : bucket)
+            {
+                size_t index = _bucketIndex(hasher(pair.first));
+                _buckets[index].push_back(std::move(pair));
+                _markOccupied(index);
+            }
+        }
+    }
+
+    /**
+     * move all the pairs of one bucket to another table, the bucket is left empty
+     * @param bucket index of the bucket we move
+     * @param other the table that gets the pairs, none of the keys is already in it
+     * @param hasher function that returns the hash of a key
+     */
+    template <class Hasher>
+    void moveBucketTo(int bucket, Table& other, Hasher hasher)
+    {
+        for (auto& pair : _buckets[bucket])
+        {
+            other.insertUnique(hasher(pair.first), std::move(pair));
+        }
+        Bucket(_buckets[bucket].get_allocator()).swap(_buckets[bucket]);
+        _markEmpty((size_t) bucket);
+    }
+
+    /**
+     *
+     * @return the position that the iteration of the table starts from, the buckets are walked in order
+     */
+    int iterationStart() const { return 0; }
+
+    /**
+     * @param position the position to look from
+     * @param start the start of the iteration, as iterationStart returned it
+     * @return the first bucket that is not empty from the position on, its first is nullptr if there is none
+     */
+    TableRun<value_type> nextRun(int position, int start)
+    {
+        (void) start;
+        size_t word = (size_t) position >> 6;
+        if (word >= _occupied.size())
+        {
+            return {nullptr, nullptr, capacity(), capacity()};
+        }
+        uint64_t bits = _occupied[word] & (~(uint64_t) 0 << (position & 63));
+        while (bits == 0)
+        {
+            if (++word == _occupied.size())
+            {
+                return {nullptr, nullptr, capacity(), capacity()};
+            }
+            bits = _occupied[word];
+        }
+        int bucket = (int) (word * 64 + (size_t) __builtin_ctzll(bits));
+        Bucket& pairs = _buckets[bucket];
+        return {pairs.data(), pairs.data() + pairs.size(), bucket, bucket + 1};
+    }
+
+    /**
+     * @param hash the hash of the key of a pair in the table
+     * @param pair pointer to the pair, as find returned it
+     * @param start the start of the iteration, as iterationStart returned it
+     * @return the rest of the bucket of the pair, from the pair on
+     */
+    TableRun<value_type> runOf(size_t hash, value_type* pair, int start)
+    {
+        (void) start;
+        int bucket = (int) _bucketIndex(hash);
+        return {pair, _buckets[bucket].data() + _buckets[bucket].size(), bucket, bucket + 1};
+    }
+
+    /**
+     * erase a pair that an iteration is at. the last pair of the bucket takes its place, so the pairs
+     * that the iteration did not visit yet stay in the rest of the run
+     * @param run the run of the pair, its last is updated
+     * @param pair the pair we erase
+     */
+    void eraseInRun(TableRun<value_type>* run, value_type* pair)
+    {
+        _eraseFrom((size_t) run->position, pair);
+        run->last = _buckets[run->position].data() + _buckets[run->position].size();
+    }
+
+private:
+
+    /**
+     * erase a pair, the last pair of its bucket takes its place
+     * @param index the bucket of the pair
+     * @param pair the pair we erase
+     */
+    void _eraseFrom(size_t index, value_type* pair)
+    {
+        Bucket& bucket = _buckets[index];
+        if (pair != &bucket.back())
+        {
+            *pair = std::move(bucket.back());
+        }
+        bucket.pop_back();
+        if (bucket.empty())
+        {
+            _markEmpty(index);
+        }
+    }
+};
+
+
+/**
+ * the table of the OpenAddressing policy.
+ * the pairs live in one array of slots, and every slot has a probe distance next to it in a
+ * separate metadata array (0 means an empty slot, otherwise it is the distance of the pair from
+ * its home slot plus 1). on insertion a pair that is further from its home than the pair in the
+ * slot takes the slot (Robin Hood), so a lookup can stop as soon as it meets a slot whose pair is
+ * closer to its home than the key would be. erase shifts the following pairs one slot back, so
+ * there are no tombstones.
+ * @tparam KeyT the type key of the hash map
+ * @tparam ValueT the type of the value in the hash map
+ * @tparam Allocator the allocator of the pairs
+ */
+template <class KeyT, class ValueT, class Allocator>
+class OpenAddressing::Table
+{
+public:
+
+    using value_type = std::pair<KeyT, ValueT>;
+
+private:
+
+    using Distance = uint32_t;
+
+    using PairAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+
+    using PairTraits = std::allocator_traits<PairAllocator>;
+
+    using DistanceAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Distance>;
+
+    /** the allocator of the slot array and of the pairs in it */
+    PairAllocator _allocator;
+
+    /** the slot array, only the slots with a non zero distance hold a constructed pair */
+    value_type* _slots;
+
+    /** the probe distance of every slot plus 1, 0 for an empty slot */
+    std::vector<Distance, DistanceAllocator> _dist;
+
+    /** number of the pairs in the table */
+    int _used;
+
+    /** an empty slot or a pair in its home slot, the iteration starts there, see iterationStart */
+    size_t _start;
+
+    /**
+     * @param hash the hash of the key
+     * @return the home slot of the hash
+     */
+    size_t _homeIndex(size_t hash) const { return hash & (_dist.size() - 1); }
+
+    /**
+     * @param index index of a slot
+     * @return the index of the slot after it
+     */
+    size_t _nextIndex(size_t index) const { return (index + 1) & (_dist.size() - 1); }
+
+    /**
+     * erase the pair in a slot and shift back the pairs after it that are not in their home slot,
+     * so no probe sequence is broken
+     * @param index index of an occupied slot
+     */
+    void _eraseAt(size_t index)
+    {
+        PairTraits::destroy(_allocator, &_slots[index]);
+        _dist[index] = 0;
+        for (size_t next = _nextIndex(index); _dist[next] > 1; next = _nextIndex(next))
+        {
+            PairTraits::construct(_allocator, &_slots[index], std::move(_slots[next]));
+            PairTraits::destroy(_allocator, &_slots[next]);
+            _dist[index] = _dist[next] - 1;
+            _dist[next] = 0;
+            index = next;
+        }
+        _used--;
+    }
+
+    /**
+     * destroy all the pairs and free the slot array
+     */
+    void _release()
+    {
+        clear();
+        if (_slots != nullptr)
+        {
+            PairTraits::deallocate(_allocator, _slots, _dist.size());
+        }
+        _slots = nullptr;
+    }
+
+public:
+
+    /**
+     * @param capacity the number of slots in the table, must be a power of 2
+     * @param allocator the allocator of the slots and the pairs
+     */
+    explicit Table(int capacity, const Allocator& allocator = Allocator()) :
+            _allocator(allocator), _slots(PairTraits::allocate(_allocator, (size_t) capacity)),
+            _dist((size_t) capacity, 0, DistanceAllocator(allocator)), _used(0), _start(0) {}
+
+    /**
+     * copy constructor
+     * @param other the table that been copied
+     */
+    Table(const Table& other) :
+            Table((int) other._dist.size(), Allocator(PairTraits::select_on_container_copy_construction(
+                    other._allocator)))
+    {
+        for (size_t i = 0; i < _dist.size(); i++)
+        {
+            if (other._dist[i] != 0)
+            {
+                PairTraits::construct(_allocator, &_slots[i], other._slots[i]);
+                _dist[i] = other._dist[i];
+                _used++;
+            }
+        }
+        _start = other._start;
+    }
+
+    /**
+     * move constructor
+     * @param other the table that been moved, it is left without slots
+     */
+    Table(Table&& other) noexcept : _allocator(other._allocator), _slots(other._slots),
+                                    _dist(std::move(other._dist)), _used(other._used), _start(other._start)
+    {
+        other._slots = nullptr;
+        other._dist.clear();
+        other._used = 0;
+        other._start = 0;
+    }
+
+    /**
+     * distructor
+     */
+    ~Table() { _release(); }
+
+    /**
+     * copy assignment
+     * @param other the table that we assign to this
+     * @return this
+     */
+    Table& operator=(const Table& other)
+    {
+        if (this != &other)
+        {
+            Table copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    /**
+     * move assignment
+     * @param other the table that we assign to this
+     * @return this
+     */
+    Table& operator=(Table&& other) noexcept
+    {
+        if (this != &other)
+        {
+            _release();
+            // the slots are taken over as they are, so they are freed by the allocator that made them
+            _allocator = other._allocator;
+            _slots = other._slots;
+            _dist = std::move(other._dist);
+            _used = other._used;
+            _start = other._start;
+            other._slots = nullptr;
+            other._dist.clear();
+            other._used = 0;
+            other._start = 0;
+        }
+        return *this;
+    }
+
+    /**
+     *
+     * @return the number of slots in the table
+     */
+    int capacity() const { return (int) _dist.size(); }
+
+    /**
+     * add the bucket lengths, the probe lengths and the bytes of the table to stats. the bucket of a slot
+     * is the pairs whose home slot it is, and the probe length of a pair is its distance from its home slot
+     * @param stats the stats
+     */
+    void collectStats(HashMapStats* stats) const
+    {
+        std::vector<int> homes(_dist.size(), 0);
+        for (size_t i = 0; i < _dist.size(); i++)
+        {
+            if (_dist[i] != 0)
+            {
+                homes[(i + 1 - _dist[i]) & (_dist.size() - 1)]++;
+                stats->addProbe((int) _dist[i]);
+            }
+        }
+        for (int length : homes)
+        {
+            stats->addBucket(length);
+        }
+        stats->bytes += _dist.size() * (sizeof(value_type) + sizeof(Distance));
+    }
+
+    /**
+     *
+     * @return the allocator of the table
+     */
+    Allocator allocator() const { return Allocator(_allocator); }
+
+    /**
+     * find a pair in the table
+     * @param hash the hash of the key we look for
+     * @param matches predicate that gets a key and returns true if it is the key we look for
+     * @return pointer to the pair of the key, nullptr if the key is not in the table
+     */
+    template <class Matches>
+    value_type* find(size_t hash, Matches matches)
+    {
+        size_t index = _homeIndex(hash);
+        for (Distance dist = 1; dist <= _dist[index]; dist++)
+        {
+            // only a pair with the same distance at this slot has the same home slot as the key
+            if (_dist[index] == dist && matches(_slots[index].first))
+            {
+                return &_slots[index];
+            }
+            index = _nextIndex(index);
+        }
+        return nullptr;
+    }
+
+    /**
+     * find a pair in the table
+     * @param hash the hash of the key we look for
+     * @param matches predicate that gets a key and returns true if it is the key we look for
+     * @return pointer to the pair of the key, nullptr if the key is not in the table
+     */
+    template <class Matches>
+    const value_type* find(size_t hash, Matches matches) const
+    {
+        return const_cast<Table*>(this)->find(hash, matches);
+    }
+
+    /**
+     * insert a pair to the table, the caller is responsible that the key is not in the table
+     * @param hash the hash of the key
+     * @param args the args that the pair is constructed from
+     * @return pointer to the new pair, nullptr if there is no free slot for it
+     */
+    template <class... Args>
+    value_type* insertUnique(size_t hash, Args&&... args)
+    {
+        if (_used == capacity())
+        {
+            return nullptr;
+        }
+        // the pair takes the first slot whose pair is closer to its home than the new one would be
+        size_t index = _homeIndex(hash);
+        Distance dist = 1;
+        for (; _dist[index] >= dist; dist++)
+        {
+            index = _nextIndex(index);
+        }
+        // the Robin Hood swaps that follow are the same as shifting the rest of the cluster one slot
+        // forward, so the pair is constructed once, in its slot
+        size_t empty = index;
+        while (_dist[empty] != 0)
+        {
+            empty = _nextIndex(empty);
+        }
+        for (size_t to = empty; to != index; )
+        {
+            size_t from = (to - 1) & (_dist.size() - 1);
+            PairTraits::construct(_allocator, &_slots[to], std::move(_slots[from]));
+            PairTraits::destroy(_allocator, &_slots[from]);
+            _dist[to] = _dist[from] + 1;
+            to = from;
+        }
+        _dist[index] = 0;
+        PairTraits::construct(_allocator, &_slots[index], std::forward<Args>(args)...);
+        _dist[index] = dist;
+        _used++;
+        // a pair was shifted out of its home slot into the start, the start moves on to the next such slot
+        for (size_t i = 0; i < _dist.size() && _dist[_start] > 1; i++)
+        {
+            _start = _nextIndex(_start);
+        }
+        return &_slots[index];
+    }
+
+    /**
+     * erase a pair from the table
+     * @param hash the hash of the key we erase
+     * @param matches predicate that gets a key and returns true if it is the key we erase
+     * @return true if we erase, false if the key is not in the table
+     */
+    template <class Matches>
+    bool erase(size_t hash, Matches matches)
+    {
+        value_type* found = find(hash, matches);
+        if (found == nullptr)
+        {
+            return false;
+        }
+        _eraseAt((size_t) (found - _slots));
+        return true;
+    }
+
+    /**
+     * @param hash the hash of a key
+     * @return the number of pairs in the table that have the same home slot as the hash
+     */
+    int bucketSize(size_t hash) const
+    {
+        int count = 0;
+        size_t index = _homeIndex(hash);
+        for (Distance dist = 1; dist <= _dist[index]; dist++)
+        {
+            if (_dist[index] == dist)
+            {
+                count++;
+            }
+            index = _nextIndex(index);
+        }
+        return count;
+    }
+
+    /**
+     * clear all the pairs from the table, the number of slots stays the same
+     */
+    void clear()
+    {
+        for (size_t i = 0; i < _dist.size(); i++)
+        {
+            if (_dist[i] != 0)
+            {
+                PairTraits::destroy(_allocator, &_slots[i]);
+                _dist[i] = 0;
+            }
+        }
+        _used = 0;
+    }
+
+    /**
+     * change the number of slots of the table, the pairs are moved to their new slots without
+     * copying them and without checking for duplicates
+     * @param capacity the new number of slots, must be a power of 2 and larger than the number of
+     * pairs in the table
+     * @param hasher function that returns the hash of a key
+     */
+    template <class Hasher>
+    void rehash(int capacity, Hasher hasher)
+    {
+        Table other(capacity, allocator());
+        for (size_t i = 0; i < _dist.size(); i++)
+        {
+            if (_dist[i] != 0)
+            {
+                other.insertUnique(hasher(_slots[i].first), std::move(_slots[i]));
+            }
+        }
+        *this = std::move(other);
+    }
+
+    /**
+     * move all the pairs that sit in one slot to another table. erasing a pair shifts the next
+     * pairs of the cluster back into the slot, so the slot is emptied until it stays empty and
+     * the probe sequences of the pairs that are left stay valid.
+     * @param bucket index of the slot we move
+     * @param other the table that gets the pairs, none of the keys is already in it
+     * @param hasher function that returns the hash of a key
+     */
+    template <class Hasher>
+    void moveBucketTo(int bucket, Table& other, Hasher hasher)
+    {
+        while (_dist[bucket] != 0)
+        {
+            other.insertUnique(hasher(_slots[bucket].first), std::move(_slots[bucket]));
+            _eraseAt((size_t) bucket);
+        }
+    }
+
+    /**
+     * the iteration starts at an empty slot or at a pair in its home slot, and goes around the table
+     * from there. an erase shifts pairs back only up to such a slot, so erasing the pair that an
+     * iteration is at moves only pairs that it did not visit yet, and never one that it already visited.
+     * the slot is kept up to date by the inserts (an erase leaves it such a slot), so it is not looked for
+     * on every begin or find
+     * @return the slot that the iteration of the table starts from
+     */
+    int iterationStart() const { return (int) _start; }
+
+    /**
+     * @param position the position to look from, the slot start + position
+     * @param start the start of the iteration, as iterationStart returned it
+     * @return the first run of occupied slots from the position on, its first is nullptr if there is none
+     */
+    TableRun<value_type> nextRun(int position, int start)
+    {
+        for (; position < capacity(); position++)
+        {
+            size_t index = ((size_t) start + (size_t) position) & (_dist.size() - 1);
+            if (_dist[index] != 0)
+            {
+                return _runFrom(index, position, start);
+            }
+        }
+        return {nullptr, nullptr, capacity(), capacity()};
+    }
+
+    /**
+     * @param hash the hash of the key of a pair in the table
+     * @param pair pointer to the pair, as find returned it
+     * @param start the start of the iteration, as iterationStart returned it
+     * @return the run of occupied slots from the pair on
+     */
+    TableRun<value_type> runOf(size_t hash, value_type* pair, int start)
+    {
+        (void) hash;
+        size_t index = (size_t) (pair - _slots);
+        return _runFrom(index, (int) ((index - (size_t) start) & (_dist.size() - 1)), start);
+    }
+
+    /**
+     * erase a pair that an iteration is at. the pairs after it are shifted back until an empty slot
+     * or a pair in its home slot, so the run may end at an empty slot now, and the iteration goes on
+     * after it
+     * @param run the run of the pair, its last and next are updated
+     * @param pair the pair we erase
+     */
+    void eraseInRun(TableRun<value_type>* run, value_type* pair)
+    {
+        size_t index = (size_t) (pair - _slots);
+        _eraseAt(index);
+        value_type* last = pair;
+        while (last != run->last && _dist[(size_t) (last - _slots)] != 0)
+        {
+            last++;
+        }
+        run->next -= (int) (run->last - last);
+        run->last = last;
+    }
+
+private:
+
+    /**
+     * @param index an occupied slot
+     * @param position the position of the slot in the iteration
+     * @param start the start of the iteration
+     * @return the occupied slots from the slot on, up to an empty slot, the end of the slot array, or the
+     * start of the iteration, so a run is always contiguous in memory
+     */
+    TableRun<value_type> _runFrom(size_t index, int position, int start)
+    {
+        size_t end = index < (size_t) start ? (size_t) start : _dist.size();
+        size_t last = index + 1;
+        while (last < end && _dist[last] != 0)
+        {
+            last++;
+        }
+        return {&_slots[index], &_slots[last], position, position + (int) (last - index)};
+    }
+};
+
+/// ### end of storage policies ###///
+
+
+#endif //EX3_HASHMAPSTORAGE_HPP
@@ -0,0 +1,140 @@
+#ifndef EX3_MAPPEDFILE_HPP
+#define EX3_MAPPEDFILE_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+/**
+ * this class reprasents a read only file that is read without copying it into a string. a regular file is
+ * mapped into memory, anything else (a pipe, a fifo, a device) is read in fixed size chunks, so only one
+ * chunk of it is in memory at a time.
+ */
+class MappedFile
+{
+private:
+
+    /** the size of a chunk that is read from a file that is not mapped */
+    static constexpr size_t CHUNK = 1 << 16;
+
+    /** the file descriptor, -1 if the file could not be opened */
+    int _fd;
+
+    /** the mapped bytes of the file, nullptr if it is not mapped */
+    const char* _data;
+
+    /** the number of mapped bytes */
+    size_t _size;
+
+public:
+
+    /**
+     * open a file, and map it if it is a regular file that is not empty
+     * @param path the path of the file
+     */
+    explicit MappedFile(const std::string& path) : _fd(::open(path.c_str(), O_RDONLY)), _data(nullptr), _size(0)
+    {
+        struct stat info;
+        if (_fd < 0 || ::fstat(_fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0)
+        {
+            return;
+        }
+        void* data = ::mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (data == MAP_FAILED)
+        {
+            return;
+        }
+        ::madvise(data, (size_t) info.st_size, MADV_SEQUENTIAL);
+        _data = (const char*) data;
+        _size = (size_t) info.st_size;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * unmap and close the file
+     */
+    ~MappedFile()
+    {
+        if (_data != nullptr)
+        {
+            ::munmap((void*) _data, _size);
+        }
+        if (_fd >= 0)
+        {
+            ::close(_fd);
+        }
+    }
+
+    /**
+     *
+     * @return true if the file was opened
+     */
+    bool good() const { return _fd >= 0; }
+
+    /**
+     *
+     * @return true if the whole file is mapped, then data() and size() are its bytes
+     */
+    bool mapped() const { return _data != nullptr; }
+
+    /**
+     *
+     * @return the mapped bytes, nullptr if the file is not mapped
+     */
+    const char* data() const { return _data; }
+
+    /**
+     *
+     * @return the number of mapped bytes
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * pass the bytes of the file to a consumer, in one piece if it is mapped and in chunks otherwise
+     * @param consume called with (const char* data, size_t length) for every piece, in order
+     * @return true if the whole file was read, false on a read error
+     */
+    template <class Consumer>
+    bool forEachChunk(Consumer consume)
+    {
+        if (mapped())
+        {
+            consume(_data, _size);
+            return true;
+        }
+        if (!good())
+        {
+            return false;
+        }
+        std::vector<char> chunk(CHUNK);
+        while (true)
+        {
+            ssize_t length = ::read(_fd, chunk.data(), chunk.size());
+            if (length < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (length < 0)
+            {
+                return false;
+            }
+            if (length == 0)
+            {
+                return true;
+            }
+            consume((const char*) chunk.data(), (size_t) length);
+        }
+    }
+};
+
+
+#endif //EX3_MAPPEDFILE_HPP
@@ -0,0 +1,742 @@
+#ifndef EX3_PHRASEMATCHER_HPP
+#define EX3_PHRASEMATCHER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include "HashMap.hpp"
+
+#define PHRASE_MATCHER_IMAGE_INVALID_MSG "PhraseMatcher Invalid Image"
+
+
+/**
+ * the PhraseMatcherInvalidImageException class represents an image of a PhraseMatcher that is not
+ * valid: a file of another format, another version, or a truncated one
+ */
+class PhraseMatcherInvalidImageException : public InvalidInputException
+{
+    /**
+    * @return the error msg to std cerr in case of this error
+    */
+    inline const char* what() const noexcept override { return PHRASE_MATCHER_IMAGE_INVALID_MSG; }
+};
+
+
+/**
+ * this class reprasents an Aho-Corasick automaton over the phrases of a spam database. it is built
+ * once from the database, and then scores a message in a single pass over its chars, no matter
+ * how many phrases there are.
+ * the score of a message is the sum of count * value over all the phrases, where count is the
+ * number of non overlapping occurrences of the phrase, counted from left to right (the same as
+ * searching the phrase again from the end of its last occurrence). occurrences of different
+ * phrases may overlap.
+ * all the arrays of the automaton live in one flat image (a header and then the arrays one after the
+ * other). a built automaton owns its image, and save() writes it as is, so an automaton that is
+ * loaded back from a mapped file points into the file and needs no parsing and no allocation.
+ * the automaton is immutable after it is built, so many Scan objects can use it at once.
+ */
+class PhraseMatcher
+{
+private:
+
+    /** the root node of the trie */
+    static constexpr int ROOT = 0;
+
+    /** marks a missing node or pattern */
+    static constexpr int NONE = -1;
+
+    /** the first bytes of an image */
+    static constexpr char IMAGE_MAGIC[8] = {'\x89', 'S', 'P', 'A', 'M', 'A', 'C', '\n'};
+
+    /** the version of the layout of an image, changed whenever the layout changes */
+    static constexpr uint32_t IMAGE_VERSION = 2;
+
+    /** written in the native byte order, an image of another byte order does not load */
+    static constexpr uint32_t IMAGE_BYTE_ORDER = 0x01020304;
+
+    /**
+     * the header of an image, followed by the arrays in the order of the Section enum, each one
+     * starting at a multiple of 8 bytes
+     */
+    struct ImageHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t nodes;
+        uint32_t phrases;
+        uint64_t blobSize;
+        uint64_t size;
+        /** the smallest value of a phrase, 0 when there are no phrases */
+        int64_t minValue;
+        /** the most that one char of a message can add to the score, see Scan::decided */
+        int64_t maxGain;
+        int32_t rootNext[256];
+    };
+
+    /** the arrays of an image */
+    enum Section
+    {
+        FAIL, OUT, PHRASE_AT, EDGE_START, EDGE_TARGET, EDGE_CHAR, LENGTH, VALUE, PHRASE_START, BLOB, SECTIONS
+    };
+
+    /** the header of the image */
+    const ImageHeader* _header;
+
+    /** the node that the root goes to on every char, ROOT when no phrase starts with the char */
+    const int32_t* _rootNext;
+
+    /** the failure link of every node, the node of the longest proper suffix that is in the trie */
+    const int32_t* _fail;
+
+    /** for every node, the nearest node on its failure chain that ends a phrase, or NONE */
+    const int32_t* _out;
+
+    /** the phrase that ends in every node, or NONE */
+    const int32_t* _phraseAt;
+
+    /** the edges of node i are _edgeChar / _edgeTarget [_edgeStart[i], _edgeStart[i + 1]) */
+    const int32_t* _edgeStart;
+
+    /** the char of every edge */
+    const unsigned char* _edgeChar;
+
+    /** the node every edge goes to */
+    const int32_t* _edgeTarget;
+
+    /** the length of every phrase */
+    const uint32_t* _length;
+
+    /** the value of every phrase */
+    const int32_t* _value;
+
+    /** phrase i is _blob [_phraseStart[i], _phraseStart[i + 1]) */
+    const uint64_t* _phraseStart;
+
+    /** the chars of all the phrases, one after the other */
+    const char* _blob;
+
+    /** the number of nodes in the trie */
+    int _nodes;
+
+    /** the number of phrases */
+    int _phrases;
+
+    /** the image of a built automaton, empty when the image is loaded */
+    std::vector<uint64_t> _storage;
+
+    /** keeps the memory of a loaded image alive */
+    std::shared_ptr<const void> _owner;
+
+    /**
+     * @param node a node of the trie
+     * @param c a char
+     * @return the child of the node on the char, NONE if there is none
+     */
+    int _child(int node, unsigned char c) const
+    {
+        if (node == ROOT)
+        {
+            return _rootNext[c];
+        }
+        for (int edge = _edgeStart[node]; edge < _edgeStart[node + 1]; edge++)
+        {
+            if (_edgeChar[edge] == c)
+            {
+                return _edgeTarget[edge];
+            }
+        }
+        return NONE;
+    }
+
+    /**
+     * the goto function of the automaton
+     * @param node the current node
+     * @param c the next char of the message
+     * @return the node of the longest suffix of the text read so far that is in the trie
+     */
+    int _next(int node, unsigned char c) const
+    {
+        while (true)
+        {
+            int child = _child(node, c);
+            if (child != NONE)
+            {
+                return child;
+            }
+            node = _fail[node];
+        }
+    }
+
+    /**
+     * compute where every array starts in an image
+     * @param nodes the number of nodes in the trie
+     * @param phrases the number of phrases
+     * @param blobSize the number of chars of all the phrases
+     * @param offsets gets the offset of every array from the start of the image
+     * @return the size of the image in bytes
+     */
+    static uint64_t _layout(uint64_t nodes, uint64_t phrases, uint64_t blobSize, uint64_t offsets[SECTIONS])
+    {
+        const uint64_t sizes[SECTIONS] = {nodes * 4, nodes * 4, nodes * 4, (nodes + 1) * 4, nodes * 4, nodes,
+                                          phrases * 4, phrases * 4, (phrases + 1) * 8, blobSize};
+        uint64_t offset = sizeof(ImageHeader);
+        for (int section = 0; section < SECTIONS; section++)
+        {
+            offsets[section] = offset;
+            offset += (sizes[section] + 7) & ~(uint64_t) 7;
+        }
+        return offset;
+    }
+
+    /**
+     * point the arrays of the automaton into an image
+     * @param image the image, its header was checked
+     */
+    void _attach(const char* image)
+    {
+        _header = (const ImageHeader*) image;
+        uint64_t offsets[SECTIONS];
+        _layout(_header->nodes, _header->phrases, _header->blobSize, offsets);
+        _nodes = (int) _header->nodes;
+        _phrases = (int) _header->phrases;
+        _rootNext = _header->rootNext;
+        _fail = (const int32_t*) (image + offsets[FAIL]);
+        _out = (const int32_t*) (image + offsets[OUT]);
+        _phraseAt = (const int32_t*) (image + offsets[PHRASE_AT]);
+        _edgeStart = (const int32_t*) (image + offsets[EDGE_START]);
+        _edgeTarget = (const int32_t*) (image + offsets[EDGE_TARGET]);
+        _edgeChar = (const unsigned char*) (image + offsets[EDGE_CHAR]);
+        _length = (const uint32_t*) (image + offsets[LENGTH]);
+        _value = (const int32_t*) (image + offsets[VALUE]);
+        _phraseStart = (const uint64_t*) (image + offsets[PHRASE_START]);
+        _blob = image + offsets[BLOB];
+    }
+
+    /**
+     * build the automaton from the phrases
+     * @param phrases the phrases and their values, an empty phrase is skipped
+     */
+    void _build(const std::vector<std::pair<std::string_view, int>>& phrases);
+
+    /**
+     * check the arrays of a loaded image, so a damaged image cannot make a scan read outside of it or loop
+     * forever: every link goes to a node or a phrase that exists, the edges make a tree of all the nodes, a
+     * failure or out link goes to a shallower node, and the phrases are in order inside the blob
+     * @return true if the arrays are valid
+     */
+    bool _valid() const;
+
+public:
+
+    /**
+     * Build the automaton from a database
+     * @param database a map from a phrase to its value, for example HashMap<std::string, int>
+     */
+    template <class Map>
+    explicit PhraseMatcher(const Map& database)
+    {
+        std::vector<std::pair<std::string_view, int>> phrases;
+        for (const auto& pair : database)
+        {
+            phrases.emplace_back(pair.first, pair.second);
+        }
+        _build(phrases);
+    }
+
+    /**
+     * Load an automaton from an image that save() wrote, without copying it. the header and the sizes are
+     * checked, and the arrays are checked once in a single pass over them
+     * @param image the image, aligned to 8 bytes (a mapped file is)
+     * @param size the size of the image in bytes
+     * @param owner keeps the memory of the image alive for as long as the automaton lives, may be nullptr
+     * @throw PhraseMatcherInvalidImageException if the image is not valid
+     */
+    PhraseMatcher(const char* image, size_t size, std::shared_ptr<const void> owner) : _owner(std::move(owner))
+    {
+        if (!isImage(image, size) || ((uintptr_t) image & 7) != 0)
+        {
+            throw PhraseMatcherInvalidImageException();
+        }
+        const ImageHeader* header = (const ImageHeader*) image;
+        uint64_t offsets[SECTIONS];
+        if (header->version != IMAGE_VERSION || header->byteOrder != IMAGE_BYTE_ORDER || header->nodes == 0 ||
+            header->size != size || _layout(header->nodes, header->phrases, header->blobSize, offsets) != size ||
+            header->maxGain < 0)
+        {
+            throw PhraseMatcherInvalidImageException();
+        }
+        _attach(image);
+        if (!_valid())
+        {
+            throw PhraseMatcherInvalidImageException();
+        }
+    }
+
+    PhraseMatcher(const PhraseMatcher&) = delete;
+
+    PhraseMatcher& operator=(const PhraseMatcher&) = delete;
+
+    /**
+     * @param data the first bytes of a file
+     * @param size the number of bytes
+     * @return true if the bytes start like an image of a PhraseMatcher
+     */
+    static bool isImage(const char* data, size_t size)
+    {
+        return size >= sizeof(ImageHeader) && std::memcmp(data, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) == 0;
+    }
+
+    /**
+     * write the image of the automaton, it can be mapped and loaded back by the image constructor
+     * on a machine with the same byte order
+     * @param out the stream we write to
+     * @return true if the whole image was written
+     */
+    bool save(std::ostream& out) const
+    {
+        out.write((const char*) _header, (std::streamsize) _header->size);
+        return out.good();
+    }
+
+    /**
+     *
+     * @return the number of phrases in the automaton
+     */
+    int phrases() const { return _phrases; }
+
+    /**
+     * @param phrase the index of a phrase, in [0, phrases())
+     * @return the chars of the phrase
+     */
+    std::string_view phrase(int phrase) const
+    {
+        return std::string_view(_blob + _phraseStart[phrase], _phraseStart[phrase + 1] - _phraseStart[phrase]);
+    }
+
+    /**
+     * @param phrase the index of a phrase, in [0, phrases())
+     * @return the value of the phrase
+     */
+    int value(int phrase) const { return _value[phrase]; }
+
+    /**
+     *
+     * @return true if no phrase has a negative value, so the score of a message only goes up as it is
+     * scanned, and a scan can stop once it reaches a threshold
+     */
+    bool monotonic() const { return _header->minValue >= 0; }
+
+    /**
+     *
+     * @return the most that one char can add to the score: the sum of the positive values of the phrases
+     * that end together at the node that adds the most
+     */
+    int64_t maxGain() const { return _header->maxGain; }
+
+    /**
+     * the state of scoring one message, the message can be fed in pieces, a phrase that is split
+     * between two pieces is still found
+     */
+    class Scan
+    {
+    private:
+
+        /** the automaton */
+        const PhraseMatcher* _matcher;
+
+        /** the current node */
+        int _node;
+
+        /** the number of chars that were fed */
+        size_t _position;
+
+        /** the score so far */
+        int _score;
+
+        /** for every phrase, the position after its last counted occurrence */
+        std::vector<size_t> _lastEnd;
+
+        /** the phrases that have a counted occurrence, only their _lastEnd is cleared by reset */
+        std::vector<int> _counted;
+
+        /** the score that the scan stops at, LLONG_MAX when it never stops */
+        long long _stopAt;
+
+        /** the number of chars of the message, SIZE_MAX when it is not known */
+        size_t _length;
+
+        /** true if chars of the message were not scanned since the verdict was already known */
+        bool _skipped;
+
+    public:
+
+        /**
+         * start scoring a message
+         * @param matcher the automaton
+         */
+        explicit Scan(const PhraseMatcher& matcher) : _matcher(&matcher), _node(ROOT), _position(0), _score(0),
+                                                     _lastEnd((size_t) matcher._phrases, 0), _stopAt(LLONG_MAX),
+                                                     _length(SIZE_MAX), _skipped(false)
+        {
+        }
+
+        /**
+         * feed the next chars of the message
+         * @param data the chars
+         * @param length the number of chars
+         */
+        void feed(const char* data, size_t length);
+
+        /**
+         *
+         * @return the score of the chars that were fed so far
+         */
+        int score() const { return _score; }
+
+        /**
+         * stop scanning a message once its score reaches the threshold, the rest of it is not scanned and
+         * score() is the score so far. it does nothing if the matcher is not monotonic(). it is kept by reset
+         * @param threshold the score that decides the verdict
+         */
+        void stopAt(int threshold)
+        {
+            if (_matcher->monotonic())
+            {
+                _stopAt = threshold;
+            }
+        }
+
+        /**
+         * the number of chars of the message, with stopAt it lets decided() tell that the chars that are left
+         * cannot reach the threshold any more. reset forgets it
+         * @param length the number of chars that will be fed at most
+         */
+        void expectLength(size_t length) { _length = length; }
+
+        /**
+         *
+         * @return true if the scan stops at a threshold and the verdict is known: the score reached the
+         * threshold, or even if every char that is left added maxGain() the score would stay below it
+         */
+        bool decided() const
+        {
+            if (_score >= _stopAt)
+            {
+                return true;
+            }
+            if (_stopAt == LLONG_MAX || _length == SIZE_MAX)
+            {
+                return false;
+            }
+            uint64_t left = _length > _position ? _length - _position : 0;
+            int64_t gain = _matcher->maxGain();
+            return gain == 0 || left <= (uint64_t) ((_stopAt - _score - 1) / gain);
+        }
+
+        /**
+         *
+         * @return true if chars of the message were not scanned, since the verdict was known before them
+         */
+        bool skipped() const { return _skipped; }
+
+        /**
+         * start scoring a new message with the same scan, without allocating again
+         */
+        void reset()
+        {
+            for (int phrase : _counted)
+            {
+                _lastEnd[phrase] = 0;
+            }
+            _counted.clear();
+            _node = ROOT;
+            _position = 0;
+            _score = 0;
+            _length = SIZE_MAX;
+            _skipped = false;
+        }
+    };
+
+    /**
+     * score a whole message
+     * @param msg the message
+     * @return the sum of count * value over all the phrases
+     */
+    int score(std::string_view msg) const
+    {
+        Scan scan(*this);
+        scan.feed(msg.data(), msg.size());
+        return scan.score();
+    }
+};
+
+
+/**
+ * build the automaton from the phrases
+ * @param phrases the phrases and their values, an empty phrase is skipped
+ */
+inline void PhraseMatcher::_build(const std::vector<std::pair<std::string_view, int>>& phrases)
+{
+    // the phrases are added to the trie in sorted order, so a phrase shares with the trie exactly its common prefix
+    // with the phrase before it, and no edge is ever looked up. a phrase keeps the index of its place in phrases
+    std::vector<int> parent(1, NONE);
+    std::vector<unsigned char> parentChar(1, 0);
+    std::vector<int32_t> phraseAt(1, NONE);
+    std::vector<uint32_t> length;
+    std::vector<int32_t> value;
+    std::vector<uint64_t> phraseStart(1, 0);
+    std::vector<std::pair<std::string_view, int32_t>> order;
+    for (size_t i = 0; i < phrases.size(); i++)
+    {
+        if (phrases[i].first.empty())
+        {
+            continue;
+        }
+        order.emplace_back(phrases[i].first, (int32_t) length.size());
+        length.push_back((uint32_t) phrases[i].first.size());
+        value.push_back(phrases[i].second);
+        phraseStart.push_back(phraseStart.back() + phrases[i].first.size());
+    }
+    // equal phrases stay in the order of phrases, so the last one of them ends in the node, as if they were inserted
+    std::sort(order.begin(), order.end());
+    std::vector<int> path(1, ROOT);
+    std::string_view previous;
+    for (const auto& sorted : order)
+    {
+        std::string_view phrase = sorted.first;
+        size_t common = 0;
+        while (common < phrase.size() && common < previous.size() && phrase[common] == previous[common])
+        {
+            common++;
+        }
+        path.resize(common + 1);
+        int node = path.back();
+        for (size_t c = common; c < phrase.size(); c++)
+        {
+            parent.push_back(node);
+            parentChar.push_back((unsigned char) phrase[c]);
+            phraseAt.push_back(NONE);
+            node = (int) parent.size() - 1;
+            path.push_back(node);
+        }
+        phraseAt[node] = sorted.second;
+        previous = phrase;
+    }
+
+    // the image is allocated once, and the arrays are filled in place
+    uint64_t nodes = parent.size(), count = length.size(), offsets[SECTIONS];
+    uint64_t size = _layout(nodes, count, phraseStart.back(), offsets);
+    _storage.assign(size / 8, 0);
+    char* image = (char*) _storage.data();
+    ImageHeader* header = (ImageHeader*) image;
+    std::memcpy(header->magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    header->version = IMAGE_VERSION;
+    header->byteOrder = IMAGE_BYTE_ORDER;
+    header->nodes = (uint32_t) nodes;
+    header->phrases = (uint32_t) count;
+    header->blobSize = phraseStart.back();
+    header->size = size;
+    int32_t* fail = (int32_t*) (image + offsets[FAIL]);
+    int32_t* out = (int32_t*) (image + offsets[OUT]);
+    int32_t* edgeStart = (int32_t*) (image + offsets[EDGE_START]);
+    int32_t* edgeTarget = (int32_t*) (image + offsets[EDGE_TARGET]);
+    unsigned char* edgeChar = (unsigned char*) (image + offsets[EDGE_CHAR]);
+    std::copy(phraseAt.begin(), phraseAt.end(), (int32_t*) (image + offsets[PHRASE_AT]));
+    std::copy(length.begin(), length.end(), (uint32_t*) (image + offsets[LENGTH]));
+    std::copy(value.begin(), value.end(), (int32_t*) (image + offsets[VALUE]));
+    std::copy(phraseStart.begin(), phraseStart.end(), (uint64_t*) (image + offsets[PHRASE_START]));
+    char* blob = image + offsets[BLOB];
+    for (const auto& phrase : phrases)
+    {
+        blob = std::copy(phrase.first.begin(), phrase.first.end(), blob);
+    }
+    _attach(image);
+
+    // pack the edges of every node next to each other, counting sort by the parent
+    for (uint64_t node = 1; node < nodes; node++)
+    {
+        edgeStart[parent[node] + 1]++;
+    }
+    for (uint64_t node = 0; node < nodes; node++)
+    {
+        edgeStart[node + 1] += edgeStart[node];
+    }
+    std::vector<int> filled(edgeStart, edgeStart + nodes);
+    for (uint64_t node = 1; node < nodes; node++)
+    {
+        int edge = filled[parent[node]]++;
+        edgeChar[edge] = parentChar[node];
+        edgeTarget[edge] = (int32_t) node;
+    }
+    for (int32_t& next : header->rootNext)
+    {
+        next = ROOT;
+    }
+    for (int edge = edgeStart[ROOT]; edge < edgeStart[ROOT + 1]; edge++)
+    {
+        header->rootNext[edgeChar[edge]] = edgeTarget[edge];
+    }
+
+    // breadth first over the trie, the failure link of a node is found from the failure link of its parent
+    std::fill(fail, fail + nodes, ROOT);
+    std::fill(out, out + nodes, NONE);
+    std::vector<int> queue;
+    queue.reserve((size_t) nodes);
+    queue.push_back(ROOT);
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        int node = queue[head];
+        for (int edge = edgeStart[node]; edge < edgeStart[node + 1]; edge++)
+        {
+            int child = edgeTarget[edge];
+            if (node != ROOT)
+            {
+                fail[child] = _next(fail[node], edgeChar[edge]);
+            }
+            int failed = fail[child];
+            out[child] = phraseAt[failed] != NONE ? failed : out[failed];
+            queue.push_back(child);
+        }
+    }
+
+    // a char adds the values of the phrases that end at its node and on the out chain of the node. an out link
+    // goes to a shallower node, so in breadth first order the gain of the chain is known before it is needed
+    header->minValue = 0;
+    header->maxGain = 0;
+    for (int32_t phraseValue : value)
+    {
+        header->minValue = std::min(header->minValue, (int64_t) phraseValue);
+    }
+    std::vector<int64_t> gain((size_t) nodes, 0);
+    for (int node : queue)
+    {
+        gain[node] = (phraseAt[node] != NONE ? std::max(value[phraseAt[node]], 0) : 0) +
+                     (out[node] != NONE ? gain[out[node]] : 0);
+        header->maxGain = std::max(header->maxGain, gain[node]);
+    }
+}
+
+/**
+ * check the arrays of a loaded image
+ * @return true if the arrays are valid
+ */
+inline bool PhraseMatcher::_valid() const
+{
+    for (int32_t next : _header->rootNext)
+    {
+        if (next < 0 || next >= _nodes)
+        {
+            return false;
+        }
+    }
+    if (_edgeStart[ROOT] != 0)
+    {
+        return false;
+    }
+    for (int node = 0; node < _nodes; node++)
+    {
+        // the edge arrays have room for one edge per node, one more than a tree has
+        if (_edgeStart[node + 1] < _edgeStart[node] || _edgeStart[node + 1] > _nodes)
+        {
+            return false;
+        }
+    }
+    // breadth first from the root, every node is reached once and gets its depth
+    std::vector<int> depth((size_t) _nodes, NONE);
+    std::vector<int> queue(1, ROOT);
+    depth[ROOT] = 0;
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        int node = queue[head];
+        for (int edge = _edgeStart[node]; edge < _edgeStart[node + 1]; edge++)
+        {
+            int child = _edgeTarget[edge];
+            if (child < 0 || child >= _nodes || depth[child] != NONE)
+            {
+                return false;
+            }
+            depth[child] = depth[node] + 1;
+            queue.push_back(child);
+        }
+    }
+    if ((int) queue.size() != _nodes)
+    {
+        return false;
+    }
+    for (int node = 0; node < _nodes; node++)
+    {
+        int fail = _fail[node], out = _out[node], phrase = _phraseAt[node];
+        if (phrase < NONE || phrase >= _phrases)
+        {
+            return false;
+        }
+        // the root never follows its failure link, every char of the root goes through _rootNext
+        if (node != ROOT && (fail < 0 || fail >= _nodes || depth[fail] >= depth[node]))
+        {
+            return false;
+        }
+        if (out != NONE && (out < 0 || out >= _nodes || depth[out] >= depth[node] || _phraseAt[out] == NONE))
+        {
+            return false;
+        }
+    }
+    for (int phrase = 0; phrase < _phrases; phrase++)
+    {
+        if (_phraseStart[phrase + 1] < _phraseStart[phrase])
+        {
+            return false;
+        }
+    }
+    return _phraseStart[_phrases] <= _header->blobSize;
+}
+
+/**
+ * feed the next chars of the message
+ * @param data the chars
+ * @param length the number of chars
+ */
+inline void PhraseMatcher::Scan::feed(const char* data, size_t length)
+{
+    if (decided())
+    {
+        _skipped = _skipped || length > 0;
+        return;
+    }
+    const PhraseMatcher& matcher = *_matcher;
+    for (size_t i = 0; i < length; i++)
+    {
+        _node = matcher._next(_node, (unsigned char) data[i]);
+        _position++;
+        int found = matcher._phraseAt[_node] != NONE ? _node : matcher._out[_node];
+        for (; found != NONE; found = matcher._out[found])
+        {
+            int phrase = matcher._phraseAt[found];
+            // an occurrence is counted only if it starts after the last counted one of the same phrase ended
+            if (_position - matcher._length[phrase] >= _lastEnd[phrase])
+            {
+                if (_lastEnd[phrase] == 0)
+                {
+                    _counted.push_back(phrase);
+                }
+                _lastEnd[phrase] = _position;
+                _score += matcher._value[phrase];
+                if (_score >= _stopAt)
+                {
+                    _skipped = i + 1 < length;
+                    return;
+                }
+            }
+        }
+    }
+}
+
+
+#endif //EX3_PHRASEMATCHER_HPP
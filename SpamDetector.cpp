@@ -2,13 +2,51 @@
 /*******************************************include********************************************************************/
 #include <iostream>
 #include <fstream>
+#include <iterator>
+#include <vector>
+#include <memory>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
 #include "HashMap.hpp"
+#include "PhraseMatcher.hpp"
+#include "TokenMatcher.hpp"
+#include "WorkStealingPool.hpp"
+#include "MappedFile.hpp"
+#include "TextNormalize.hpp"
+#include "AtomicSnapshot.hpp"
+#include "UnixSocketServer.hpp"
 
 /***********************************************define*****************************************************************/
-static const std::string USAGE_MSG = "Usage: SpamDetector <database path> <message path> <threshold>";
+static const std::string USAGE_MSG = "Usage: SpamDetector [--stats] [--early] [--tokens K] <database path> <message path> "
+                                     "<threshold>\n"
+                                     "       SpamDetector [--stats] [--early] [--tokens K] --batch [--threads N] <database path> "
+                                     "<threshold> <messages directory | messages list file | ->\n"
+                                     "       SpamDetector [--stats] compile <database path> <snapshot path>\n"
+                                     "       SpamDetector [--stats] [--early] [--tokens K] serve <database path> <threshold> "
+                                     "<socket path>";
+static const std::string BATCH_FLAG = "--batch";
+static const std::string THREADS_FLAG = "--threads";
+static const std::string STATS_FLAG = "--stats";
+static const std::string EARLY_FLAG = "--early";
+static const std::string TOKENS_FLAG = "--tokens";
+static const std::string COMPILE_COMMAND = "compile";
+static const std::string SERVE_COMMAND = "serve";
+static const std::string SNAPSHOT_TMP_SUFFIX = ".tmp";
+static const std::string STDIN_SOURCE = "-";
 static const std::string IVALID_MSG = "Invalid input";
 static const std::string SPAM_MSG = "SPAM";
 static const std::string NOT_SPAM_MSG = "NOT_SPAM";
+static const std::string EARLY_MSG = "early";
+static const std::string FULL_MSG = "full";
 
 #define ARGS_NUM 4
 #define SEPARATE ','
@@ -16,6 +54,29 @@ static const std::string NOT_SPAM_MSG = "NOT_SPAM";
 #define DATA_INDEX 1
 #define MSG_INDEX 2
 #define THRESHOLD_INDEX 3
+#define BATCH_ARGS_NUM 5
+#define BATCH_DATA_INDEX 2
+#define BATCH_THRESHOLD_INDEX 3
+#define BATCH_SOURCE_INDEX 4
+#define BATCH_THREADS_INDEX 2
+#define THREADS_PER_CORE_MAX 4
+#define PARALLEL_PARSE_MIN (1 << 20)
+#define CHUNKS_PER_THREAD 4
+#define COMPILE_ARGS_NUM 4
+#define COMPILE_DATA_INDEX 2
+#define COMPILE_SNAPSHOT_INDEX 3
+#define STDIN_MSG_SEPARATE '\0'
+#define BATCH_BLOCK 4096
+#define STDIN_CHUNK (1 << 16)
+#define MSG_BUFFER 4096
+#define NO_CHAR (-1)
+#define RELOAD_POLL_MS 100
+#define RELOAD_THREADS 1
+#define SERVE_ARGS_NUM 5
+#define SERVE_DATA_INDEX 2
+#define SERVE_THRESHOLD_INDEX 3
+#define SERVE_SOCKET_INDEX 4
+#define TOKEN_WORDS_MAX 64
 
 /*************************************************methods**************************************************************/
 
@@ -81,135 +142,880 @@ void inValidInput(std::ifstream* file)
 }
 
 /**
- * take a line and transform all the letters ther to lowercase
+ * take a line and transform all the letters ther to lowercase (the ASCII ones, as std::tolower does in the
+ * "C" locale of the program)
  * @param line the line we transform.
  */
 void toLowerCase(std :: string& line)
 {
-    for(auto& word : line)
-    {
-        word = std::tolower(word);
-    }
+    asciiLowercase(&line[0], line.size());
 }
 
 /**
  * the error handling if a line is not valid
  * @param database the data base file
- * @param msg the msg file
+ * @param msg the msg file, nullptr in batch mode
  */
 bool notValidLine(std::ifstream* database, std::ifstream* msg)
 {
     database->close();
-    msg->close();
+    if(msg != nullptr)
+    {
+        msg->close();
+    }
     std::cerr << IVALID_MSG << std::endl;
     return false;
 }
 
 /**
- * check if a line is valid
- * @param database he data base file
- * @param msg the msg file
- * @param line the line we check
- * @param map the hash map we add the value and keys to
+ * check if a line is valid and parse it
+ * @param line the line we check, without its '\n', its '\r' are removed
+ * @param key gets the lowercased phrase of the line
+ * @param val gets the number of the line
+ * @return true if the line is valid, false otherwise
  */
-bool validLine(std::ifstream* database, std::ifstream* msg,  std :: string line,
-               HashMap<std::string, int>* map)
+bool validLine(std :: string* line, std::string* key, int* val)
 {
-    int count = (int) std::count(line.begin(), line.end(), SEPARATE);
+    line->resize(removeCR(&(*line)[0], line->size()));
+    int count = (int) countByte(line->data(), line->size(), SEPARATE);
     if(count != SEPARATE_AMOUNT)
     {
-        return notValidLine(database, msg);
+        return false;
     }
-    int separate_index = (int)line.find(SEPARATE);
-    std :: string scoreStr =  line.substr((separate_index + 1), line.size());
+    int separate_index = (int)line->find(SEPARATE);
+    std :: string scoreStr =  line->substr((separate_index + 1), line->size());
     if((int) scoreStr.size() == 0 )
     {
-        return notValidLine(database, msg);
+        return false;
     }
-    int val;
-    if(!isValidInt(&val, scoreStr, false))
+    if(!isValidInt(val, scoreStr, false))
     {
-        return notValidLine(database, msg);
+        return false;
     }
-    std:: string key = line.substr(0, separate_index);
-    toLowerCase(key);
-    map->insert(key,  val);
+    key->assign(*line, 0, separate_index);
+    toLowerCase(*key);
     return true;
 }
 
+/** set by --stats, the stats of the hash map of every database that is parsed are printed to std cerr */
+static bool printStats = false;
+
+/** set by --early, a msg is scanned only until its verdict is known */
+static bool earlyExit = false;
+
+/** set by --tokens K, the msgs are scored by runs of 1 to K words with the TokenMatcher, 0 for the PhraseMatcher */
+static int tokenWords = 0;
+
 /**
- * the funck parsese the msg file
- * @param msgFile the msg file
- * @param msg the string that parse the msg to
+ * make a scan of the matcher, with --early it stops once the verdict of a msg is known
+ * @param matcher the matcher
+ * @param threshold the threshold of a spam
+ * @return the scan
+ * @tparam Matcher PhraseMatcher, or TokenMatcher with --tokens
  */
-void parseMsgFile(std::ifstream* msgFile, std :: string& msg)
+template <class Matcher>
+typename Matcher::Scan makeScan(const Matcher& matcher, int threshold)
 {
-    std :: string line;
-    while(getline(*msgFile, line))
+    typename Matcher::Scan scan(matcher);
+    if(earlyExit)
     {
-        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
-        toLowerCase(line);
-        msg += line;
-        msg += SEPARATE;
+        scan.stopAt(threshold);
     }
+    return scan;
 }
 
+/**
+ * feed the next piece of a msg to the scan. the msg is matched lowercased, without '\r', and with a ',' at the
+ * end of every line instead of the '\n'. the piece is normalized through a small buffer, so the msg is never
+ * copied whole, and a phrase that is split between two pieces is still found by the scan
+ * @param data the chars of the piece
+ * @param length the number of chars
+ * @param scan the scan of the msg
+ * @param lastChar the last char of the msg so far, NO_CHAR before the first piece
+ * @tparam Scan PhraseMatcher::Scan, or TokenMatcher::Scan with --tokens
+ */
+template <class Scan>
+void feedMsg(const char* data, size_t length, Scan* scan, int* lastChar)
+{
+    char buffer[MSG_BUFFER];
+    for(size_t i = 0; i < length; i += MSG_BUFFER)
+    {
+        if(scan->decided())
+        {
+            // the rest is not normalized, the scan only notes that it skipped it
+            scan->feed(data + i, length - i);
+            break;
+        }
+        size_t used = normalizeLines(data + i, std::min(length - i, (size_t) MSG_BUFFER), buffer, SEPARATE);
+        scan->feed(buffer, used);
+    }
+    if(length > 0)
+    {
+        *lastChar = (unsigned char) data[length - 1];
+    }
+}
 
 /**
- * calc the score for one pair in the hash map
- * @param msg the msg
- * @param key the key of the pair
- * @param value the value of the pair
- * @return the calc score by the formula
+ * end a msg, its last line gets its ',' even if the msg does not end with '\n'
+ * @param scan the scan of the msg
+ * @param lastChar the last char of the msg, NO_CHAR if it is empty
+ * @return the score of the msg
  */
-int scoreCalcForPair(const std::string& msg, const std::string& key, int value)
+template <class Scan>
+int endMsg(Scan* scan, int lastChar)
 {
-    int counter = 0;
-    for(auto i = msg.find(key); i != std::string::npos; i = msg.find(key, i + key.length()))
+    if(lastChar != NO_CHAR && lastChar != '\n')
     {
-        counter++;
+        char separate = SEPARATE;
+        scan->feed(&separate, 1);
     }
-    return counter * value;
+    return scan->score();
 }
 
 /**
- * uptating the total score of the msg that decieds if its a spam or not
+ * score a msg file, the file is mapped or read in chunks and fed to the scan piece by piece
+ * @param msg the msg file
+ * @param scan the scan of the matcher, it is reset and reused for every msg
  * @param score the score of the msg
- * @param map the map we hold the values att
- * @param msg the msg we check
+ * @return true if the whole msg was read, false otherwise
+ */
+template <class Scan>
+bool scoreMsgFile(MappedFile* msg, Scan* scan, int* score)
+{
+    scan->reset();
+    if(msg->mapped())
+    {
+        // and the ',' that endMsg may add
+        scan->expectLength(msg->size() + 1);
+    }
+    int lastChar = NO_CHAR;
+    bool read = msg->forEachChunk([&](const char* data, size_t length)
+    {
+        feedMsg(data, length, scan, &lastChar);
+    });
+    *score = endMsg(scan, lastChar);
+    return read;
+}
+
+/**
+ * score a msg that is already in memory
+ * @param msg the chars of the msg
+ * @param length the number of chars
+ * @param scan the scan of the matcher, it is reset and reused for every msg
+ * @return the score of the msg
+ */
+template <class Scan>
+int scoreMsg(const char* msg, size_t length, Scan* scan)
+{
+    scan->reset();
+    scan->expectLength(length + 1);
+    int lastChar = NO_CHAR;
+    feedMsg(msg, length, scan, &lastChar);
+    return endMsg(scan, lastChar);
+}
+
+/**
+ * parse a chunk of the database, the chunk starts at the beginning of a line and ends at the end of a line
+ * @param data the chars of the chunk
+ * @param length the number of chars
+ * @param entries gets the phrase and the number of every line of the chunk, in the order of the lines
+ * @return true if all the lines of the chunk are valid, false otherwise
+ */
+bool parseChunk(const char* data, size_t length, std::vector<std::pair<std::string, int>>* entries)
+{
+    entries->reserve(countByte(data, length, '\n') + 1);
+    std::string line, key;
+    int val;
+    size_t start = 0;
+    while(start < length)
+    {
+        const char* newline = (const char*) std::memchr(data + start, '\n', length - start);
+        size_t end = newline == nullptr ? length : (size_t) (newline - data);
+        line.assign(data + start, end - start);
+        if(!validLine(&line, &key, &val))
+        {
+            return false;
+        }
+        entries->emplace_back(std::move(key), val);
+        start = end + 1;
+    }
+    return true;
+}
+
+/**
+ * the funck parse the database file into the map. a big database is split into chunks that end at line ends,
+ * and the chunks are validated and parsed on threads, every chunk into its own partial table. the tables are
+ * merged into the map in the order of the chunks, so the first occurrence of a phrase in the file still wins,
+ * and nothing is merged unless all the chunks are valid
+ * @param data the chars of the database
+ * @param size the number of chars
+ * @param database the database file
+ * @param msg the msg file, nullptr in batch mode
+ * @param map the map that hold the values
+ * @param threads the number of threads that parse the chunks
+ * @return true if all the lines of the database are valid, false otherwise
  */
-void updateScore(int* score, HashMap<std::string, int>* map, const std::string& msg)
+bool parseDatabase(const char* data, size_t size, std::ifstream* database, std::ifstream* msg,
+                   HashMap<std::string, int>* map, int threads)
 {
-    for (HashMap<std :: string, int>::const_iterator p = map->begin(); p != map->end(); ++p)
+    size_t chunks = threads <= 1 || size < PARALLEL_PARSE_MIN ? 1 : (size_t) threads * CHUNKS_PER_THREAD;
+    std::vector<size_t> starts(1, 0);
+    for(size_t i = 1; i < chunks; i++)
+    {
+        size_t from = std::max(starts.back(), i * size / chunks);
+        const char* newline = (const char*) std::memchr(data + from, '\n', size - from);
+        if(newline == nullptr)
+        {
+            break;
+        }
+        starts.push_back((size_t) (newline - data) + 1);
+    }
+    starts.push_back(size);
+    std::vector<std::vector<std::pair<std::string, int>>> tables(starts.size() - 1);
+    std::vector<char> valid(tables.size(), true);
+    if(tables.size() == 1)
     {
-        *score += scoreCalcForPair(msg, p->first, p->second);
+        valid[0] = parseChunk(data, size, &tables[0]);
     }
+    else
+    {
+        WorkStealingPool pool(threads);
+        for(size_t i = 0; i < tables.size(); i++)
+        {
+            pool.submit([&, i](int)
+            {
+                valid[i] = parseChunk(data + starts[i], starts[i + 1] - starts[i], &tables[i]);
+            });
+        }
+        pool.wait();
+    }
+    if(std::find(valid.begin(), valid.end(), false) != valid.end())
+    {
+        return notValidLine(database, msg);
+    }
+    size_t total = 0;
+    for(const auto& table : tables)
+    {
+        total += table.size();
+    }
+    map->reserve((int) total);
+    for(auto& table : tables)
+    {
+        for(auto& entry : table)
+        {
+            map->try_emplace(std::move(entry.first), entry.second);
+        }
+        table = std::vector<std::pair<std::string, int>>();
+    }
+    return true;
+}
+
+/**
+ * the matcher of a snapshot is its automaton
+ * @param automaton the automaton of the snapshot
+ * @return the automaton
+ */
+std::unique_ptr<PhraseMatcher> buildMatcher(std::unique_ptr<PhraseMatcher> automaton, PhraseMatcher*)
+{
+    return automaton;
+}
+
+/**
+ * the token matcher of a snapshot is built from the phrases of its automaton
+ * @param automaton the automaton of the snapshot
+ * @return the matcher
+ */
+std::unique_ptr<TokenMatcher> buildMatcher(std::unique_ptr<PhraseMatcher> automaton, TokenMatcher*)
+{
+    return std::make_unique<TokenMatcher>(*automaton, tokenWords);
+}
+
+/**
+ * @param map the parsed database
+ * @return the automaton of the database
+ */
+std::unique_ptr<PhraseMatcher> buildMatcher(const HashMap<std::string, int>& map, PhraseMatcher*)
+{
+    return std::make_unique<PhraseMatcher>(map);
+}
+
+/**
+ * @param map the parsed database
+ * @return the token matcher of the database
+ */
+std::unique_ptr<TokenMatcher> buildMatcher(const HashMap<std::string, int>& map, TokenMatcher*)
+{
+    return std::make_unique<TokenMatcher>(map, tokenWords);
+}
+
+/**
+ * the automaton has no hash map, there are no stats to print
+ */
+void printMatcherStats(const PhraseMatcher&, const std::string&)
+{
+}
+
+/**
+ * with --stats print the stats of the phrase index of the token matcher, at the end of a run, so its lookups are
+ * the lookups of the msgs that were classified
+ * @param matcher the matcher
+ * @param databasePath the path of the database
+ */
+void printMatcherStats(const TokenMatcher& matcher, const std::string& databasePath)
+{
+    if(printStats)
+    {
+        std::cerr << "token index stats of " << databasePath << " (" << matcher.phrases() << " phrases of 1 to "
+                  << matcher.words() << " words):" << std::endl;
+        matcher.stats().print(std::cerr);
+    }
+}
+
+/**
+ * load the matcher of the database. a snapshot that the compile command wrote is mapped and used as is, any
+ * other file is parsed as a "phrase,number" database
+ * @param databasePath the path of the database
+ * @param database the database file
+ * @param msg the msg file, nullptr in batch mode
+ * @param threads the number of threads that parse a "phrase,number" database
+ * @return the matcher, nullptr if the database is not valid
+ * @tparam Matcher PhraseMatcher, or TokenMatcher with --tokens
+ */
+template <class Matcher>
+std::unique_ptr<Matcher> loadMatcher(const std::string& databasePath, std::ifstream* database, std::ifstream* msg,
+                                     int threads)
+{
+    auto file = std::make_shared<MappedFile>(databasePath);
+    if(file->mapped() && PhraseMatcher::isImage(file->data(), file->size()))
+    {
+        try
+        {
+            return buildMatcher(std::make_unique<PhraseMatcher>(file->data(), file->size(), file), (Matcher*) nullptr);
+        }
+        catch (const InvalidInputException& e)
+        {
+            notValidLine(database, msg);
+            return nullptr;
+        }
+    }
+    std::string content;
+    if(!file->mapped())
+    {
+        file->forEachChunk([&content](const char* data, size_t length) { content.append(data, length); });
+    }
+    HashMap<std::string, int> map;
+    if(!parseDatabase(file->mapped() ? file->data() : content.data(), file->mapped() ? file->size() : content.size(),
+                      database, msg, &map, threads))
+    {
+        return nullptr;
+    }
+    if(printStats)
+    {
+        std::cerr << "hash map stats of " << databasePath << ":" << std::endl;
+        map.stats().print(std::cerr);
+    }
+    return buildMatcher(map, (Matcher*) nullptr);
 }
 
 /**
  * the funck parse the file
  * @param database the database file
  * @param msg the msg file
+ * @param databasePath the path of the database file
+ * @param msgPath the path of the msg file, the msg is mapped from it instead of read through msg
+ * @param threshold the threshold of a spam
  * @param score the score of the msg
- * @param map the map that hold the values
+ * @param early gets true if the verdict was known before the whole msg was scanned
+ */
+template <class Matcher>
+bool parse(std::ifstream* database, std::ifstream* msg, const std::string& databasePath, const std::string& msgPath,
+           int threshold, int* score, bool* early)
+{
+    std::unique_ptr<Matcher> matcher = loadMatcher<Matcher>(databasePath, database, msg,
+                                                            (int) std::thread::hardware_concurrency());
+    if(matcher == nullptr)
+    {
+        return false;
+    }
+    msg->close();
+    typename Matcher::Scan scan = makeScan(*matcher, threshold);
+    MappedFile msgFile(msgPath);
+    int msgScore = 0;
+    if(!msgFile.good() || !scoreMsgFile(&msgFile, &scan, &msgScore))
+    {
+        std::cerr << IVALID_MSG << std::endl;
+        return false;
+    }
+    *score += msgScore;
+    *early = scan.skipped();
+    printMatcherStats(*matcher, databasePath);
+    return true;
+}
+
+/**
+ * print the verdict of one message of a batch, with --early it tells if the verdict was known before the whole
+ * message was scanned, and the score is the score up to there
+ * @param name the name of the message, its path or its number on stdin
+ * @param score the score of the message
+ * @param threshold the threshold of a spam
+ * @param early true if the verdict was known before the whole message was scanned
  */
-bool parse(std::ifstream* database, std::ifstream* msg, int* score , HashMap<std::string, int>* map)
+void printBatchVerdict(const std::string& name, int score, int threshold, bool early)
 {
+    std::cout << (threshold <= score ? SPAM_MSG : NOT_SPAM_MSG) << ' ' << score << ' ';
+    if(earlyExit)
+    {
+        std::cout << (early ? EARLY_MSG : FULL_MSG) << ' ';
+    }
+    std::cout << name << '\n';
+}
+
+/**
+ * collect the message paths of a batch
+ * @param source a directory whose regular files are the messages, or a file that lists a message path
+ * in every line
+ * @param paths the vector that we add the paths to
+ * @return true if the source could be read, false otherwise
+ */
+bool batchPaths(const std::string& source, std::vector<std::string>* paths)
+{
+    std::error_code error;
+    if(std::filesystem::is_directory(source, error))
+    {
+        for(const auto& entry : std::filesystem::directory_iterator(source, error))
+        {
+            if(entry.is_regular_file(error))
+            {
+                paths->push_back(entry.path().string());
+            }
+        }
+        std::sort(paths->begin(), paths->end());
+        return !error;
+    }
+    std::ifstream list(source, std::ios::in);
+    if(!list.good())
+    {
+        return false;
+    }
     std::string line;
-    while(getline(*database, line))
+    while(getline(list, line))
     {
         line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
-        if(!validLine(database, msg, line, map))
+        if(!line.empty())
         {
-            return false;
+            paths->push_back(line);
         }
     }
-    std:: string msgStr;
-    parseMsgFile(msg, msgStr);
-    updateScore(score, map, msgStr);
     return true;
 }
 
+/**
+ *
+ * @return true if nothing can be read from stdin right now, a read would wait for its writer
+ */
+bool stdinWouldBlock()
+{
+    pollfd in = {STDIN_FILENO, POLLIN, 0};
+    return poll(&in, 1, 0) == 0;
+}
+
+/**
+ * classify a block of messages of a batch on the pool, and print their verdicts in the order of the block
+ * @param pool the pool that scores the messages
+ * @param scans a scan for every thread of the pool
+ * @param msgs the paths of the messages, or the messages themselves
+ * @param isPaths true if msgs are paths
+ * @param firstNumber the number of the first message of the block, the name of a message that is not a path
+ * @param threshold the threshold of a spam
+ * @return true if all the messages could be read, false otherwise
+ */
+template <class Scan>
+bool classifyBlock(WorkStealingPool* pool, std::vector<Scan>* scans, const std::vector<std::string>& msgs, bool isPaths,
+                   int firstNumber, int threshold)
+{
+    std::vector<int> scores(msgs.size(), 0);
+    std::vector<char> read(msgs.size(), true);
+    std::vector<char> early(msgs.size(), false);
+    for(size_t i = 0; i < msgs.size(); i++)
+    {
+        pool->submit([&, i](int worker)
+        {
+            Scan* scan = &(*scans)[worker];
+            if(!isPaths)
+            {
+                scores[i] = scoreMsg(msgs[i].data(), msgs[i].size(), scan);
+            }
+            else
+            {
+                MappedFile msg(msgs[i]);
+                read[i] = msg.good() && scoreMsgFile(&msg, scan, &scores[i]);
+            }
+            early[i] = scan->skipped();
+        });
+    }
+    pool->wait();
+    bool allRead = true;
+    for(size_t i = 0; i < msgs.size(); i++)
+    {
+        std::string name = isPaths ? msgs[i] : std::to_string(firstNumber + (int) i);
+        if(!read[i])
+        {
+            std::cerr << IVALID_MSG << ": " << name << std::endl;
+            allRead = false;
+            continue;
+        }
+        printBatchVerdict(name, scores[i], threshold, early[i]);
+    }
+    return allRead;
+}
+
+/** set by SIGHUP, the batch mode reloads its database when it sees it (a lock free atomic, so a signal
+ * handler may set it and another thread may read it) */
+static std::atomic<bool> reloadRequested(false);
+
+/**
+ * the SIGHUP handler, it only sets the flag, the reload itself is done by the DatabaseReloader
+ */
+void requestReload(int)
+{
+    reloadRequested.store(true);
+}
+
+/**
+ * a thread that reloads the database every time a reload is requested, and publishes the new matcher.
+ * the messages are classified with the old matcher while the new one is built, and a database that
+ * cannot be loaded is reported on stderr and the old matcher is kept. it is stopped when it is destroyed.
+ * @tparam Matcher PhraseMatcher, or TokenMatcher with --tokens
+ */
+template <class Matcher>
+struct DatabaseReloader
+{
+    std::mutex lock;
+    std::condition_variable wake;
+    bool stop = false;
+    std::thread thread;
+
+    /**
+     * start the thread
+     * @param databasePath the path of the database (or its snapshot)
+     * @param current the matcher that the batch uses
+     */
+    DatabaseReloader(const std::string& databasePath, AtomicSnapshot<Matcher>* current)
+            : thread(&DatabaseReloader::run, this, databasePath, current) {}
+
+    ~DatabaseReloader()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+        }
+        wake.notify_all();
+        thread.join();
+    }
+
+    void run(const std::string& databasePath, AtomicSnapshot<Matcher>* current)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        while(!stop)
+        {
+            wake.wait_for(guard, std::chrono::milliseconds(RELOAD_POLL_MS));
+            if(stop || !reloadRequested.exchange(false))
+            {
+                continue;
+            }
+            guard.unlock();
+            std::ifstream database(databasePath, std::ios::in);
+            if(database.good())
+            {
+                // one thread, so the reload takes at most one core from the classification
+                std::unique_ptr<Matcher> matcher = loadMatcher<Matcher>(databasePath, &database, nullptr,
+                                                                        RELOAD_THREADS);
+                if(matcher != nullptr)
+                {
+                    current->publish(std::move(matcher));
+                }
+            }
+            else
+            {
+                inValidInput(&database);
+            }
+            guard.lock();
+        }
+    }
+};
+
+/**
+ * make the scans match the current matcher, after a reload they are built again for the new one
+ * @param current the matcher that the batch uses
+ * @param inUse the matcher of the scans, keeps it alive while they use it
+ * @param scans a scan per thread
+ * @param threshold the threshold of a spam
+ */
+template <class Matcher>
+void refreshScans(const AtomicSnapshot<Matcher>& current, std::shared_ptr<const Matcher>* inUse,
+                  std::vector<typename Matcher::Scan>* scans, int threshold)
+{
+    std::shared_ptr<const Matcher> matcher = current.load();
+    if(matcher == *inUse)
+    {
+        return;
+    }
+    size_t threads = scans->size();
+    scans->clear();
+    scans->resize(threads, makeScan(*matcher, threshold));
+    *inUse = std::move(matcher);
+}
+
+/**
+ * the batch mode of the program: load the database once and classify many messages, one verdict line
+ * "<SPAM|NOT_SPAM> <score> <name>" per message. the messages are the files of a directory, the files
+ * listed in a list file, or NUL separated messages on stdin. with --threads N the messages are scored by
+ * N threads that share the database, and the verdicts are still printed in the order of the messages.
+ * @param argc the number of args
+ * @param argv the aray of args
+ * @return failure if the args or the database are invalid or a message could not be read, success otherwise
+ * @tparam Matcher PhraseMatcher, or TokenMatcher with --tokens
+ */
+template <class Matcher>
+int runBatch(int argc, char *argv[])
+{
+    int threads = 1;
+    if(argc > BATCH_THREADS_INDEX && std::string(argv[BATCH_THREADS_INDEX]) == THREADS_FLAG)
+    {
+        int cores = std::max(1, (int) std::thread::hardware_concurrency());
+        if(argc <= BATCH_THREADS_INDEX + 1 || !isValidInt(&threads, std::string(argv[BATCH_THREADS_INDEX + 1]), true)
+           || threads > cores * THREADS_PER_CORE_MAX)
+        {
+            std::cerr << USAGE_MSG << std::endl;
+            return 1;
+        }
+        // skip the option, so the rest of the args are where they are without it
+        argc -= 2;
+        argv += 2;
+    }
+    if(argc != BATCH_ARGS_NUM)
+    {
+        std::cerr << USAGE_MSG << std::endl;
+        return 1;
+    }
+    int threshold = 0;
+    if(!isValidInt(&threshold, std::string(argv[BATCH_THRESHOLD_INDEX]), true))
+    {
+        std::cerr << IVALID_MSG << std::endl;
+        return 1;
+    }
+    std::ifstream database(argv[BATCH_DATA_INDEX], std::ios::in);
+    if(!database.good())
+    {
+        inValidInput(&database);
+        return 1;
+    }
+    std::shared_ptr<const Matcher> matcher = loadMatcher<Matcher>(argv[BATCH_DATA_INDEX], &database, nullptr, threads);
+    if(matcher == nullptr)
+    {
+        return 1;
+    }
+    database.close();
+    AtomicSnapshot<Matcher> current(matcher);
+    std::signal(SIGHUP, requestReload);
+    DatabaseReloader<Matcher> reloader(argv[BATCH_DATA_INDEX], &current);
+    WorkStealingPool pool(threads);
+    std::vector<typename Matcher::Scan> scans((size_t) pool.threads(), makeScan(*matcher, threshold));
+    std::string source = argv[BATCH_SOURCE_INDEX];
+    bool allRead = true;
+    if(source == STDIN_SOURCE)
+    {
+        std::vector<std::string> block;
+        std::string record;
+        int number = 1;
+        auto classifyStdin = [&]()
+        {
+            refreshScans(current, &matcher, &scans, threshold);
+            allRead &= classifyBlock(&pool, &scans, block, false, number, threshold);
+            number += (int) block.size();
+            block.clear();
+            // a writer may wait for the verdicts of what it sent before it sends more
+            std::cout.flush();
+        };
+        std::vector<char> chunk(STDIN_CHUNK);
+        ssize_t got;
+        while((got = read(STDIN_FILENO, chunk.data(), chunk.size())) != 0)
+        {
+            if(got < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            const char* data = chunk.data();
+            const char* end = data + got;
+            const char* separate;
+            while((separate = (const char*) memchr(data, STDIN_MSG_SEPARATE, end - data)) != nullptr)
+            {
+                record.append(data, separate);
+                block.push_back(std::move(record));
+                record.clear();
+                data = separate + 1;
+                if(block.size() == BATCH_BLOCK)
+                {
+                    classifyStdin();
+                }
+            }
+            record.append(data, end);
+            // the next read would wait, so the messages that came are classified without a full block
+            if(!block.empty() && stdinWouldBlock())
+            {
+                classifyStdin();
+            }
+        }
+        if(!record.empty())
+        {
+            block.push_back(std::move(record));
+        }
+        classifyStdin();
+    }
+    else
+    {
+        std::vector<std::string> paths;
+        if(!batchPaths(source, &paths))
+        {
+            std::cerr << IVALID_MSG << std::endl;
+            return 1;
+        }
+        for(size_t first = 0; first < paths.size(); first += BATCH_BLOCK)
+        {
+            std::vector<std::string> block(paths.begin() + (long) first,
+                                           paths.begin() + (long) std::min(paths.size(), first + BATCH_BLOCK));
+            refreshScans(current, &matcher, &scans, threshold);
+            allRead &= classifyBlock(&pool, &scans, block, true, 0, threshold);
+        }
+    }
+    std::cout.flush();
+    printMatcherStats(*matcher, argv[BATCH_DATA_INDEX]);
+    return allRead ? 0 : 1;
+}
+
+/**
+ * the compile command of the program: parse a "phrase,number" database once and write the snapshot of its matcher,
+ * the snapshot can then be given instead of the database and is mapped without any parsing
+ * @param argc the number of args
+ * @param argv the aray of args
+ * @return failure if the args or the database are invalid or the snapshot could not be written, success otherwise
+ */
+int runCompile(int argc, char *argv[])
+{
+    if(argc != COMPILE_ARGS_NUM)
+    {
+        std::cerr << USAGE_MSG << std::endl;
+        return 1;
+    }
+    std::ifstream database(argv[COMPILE_DATA_INDEX], std::ios::in);
+    if(!database.good())
+    {
+        inValidInput(&database);
+        return 1;
+    }
+    std::unique_ptr<PhraseMatcher> matcher = loadMatcher<PhraseMatcher>(argv[COMPILE_DATA_INDEX], &database, nullptr,
+                                                                         (int) std::thread::hardware_concurrency());
+    if(matcher == nullptr)
+    {
+        return 1;
+    }
+    database.close();
+    // written next to the snapshot and renamed over it, so a process that has the old snapshot mapped keeps it whole
+    std::string path = argv[COMPILE_SNAPSHOT_INDEX];
+    std::string tmpPath = path + SNAPSHOT_TMP_SUFFIX;
+    std::ofstream snapshot(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    bool written = snapshot.good() && matcher->save(snapshot);
+    snapshot.close();
+    std::error_code error;
+    if(!written || snapshot.fail() || (std::filesystem::rename(tmpPath, path, error), error))
+    {
+        std::filesystem::remove(tmpPath, error);
+        std::cerr << IVALID_MSG << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/** set by SIGINT and SIGTERM, the serve command stops when it sees it */
+static std::atomic<bool> stopRequested(false);
+
+/**
+ * the SIGINT and SIGTERM handler of the serve command
+ */
+void requestStop(int)
+{
+    stopRequested = true;
+}
+
+/**
+ * the serve command of the program: load the database once and classify the messages that clients send over a
+ * Unix domain socket, so a mail server does not start a process and load the database for every mail.
+ * a request is a 4 byte big endian length and the message, and its response is a 4 byte big endian length and
+ * "<SPAM|NOT_SPAM> <score>". a client may send many requests without waiting and gets the responses in their order.
+ * the database is reloaded on SIGHUP like in batch mode, and SIGINT / SIGTERM stop the server
+ * @param argc the number of args
+ * @param argv the aray of args
+ * @return failure if the args or the database are invalid or the socket could not be made, success otherwise
+ * @tparam Matcher PhraseMatcher, or TokenMatcher with --tokens
+ */
+template <class Matcher>
+int runServe(int argc, char *argv[])
+{
+    if(argc != SERVE_ARGS_NUM)
+    {
+        std::cerr << USAGE_MSG << std::endl;
+        return 1;
+    }
+    int threshold = 0;
+    if(!isValidInt(&threshold, std::string(argv[SERVE_THRESHOLD_INDEX]), true))
+    {
+        std::cerr << IVALID_MSG << std::endl;
+        return 1;
+    }
+    std::ifstream database(argv[SERVE_DATA_INDEX], std::ios::in);
+    if(!database.good())
+    {
+        inValidInput(&database);
+        return 1;
+    }
+    std::shared_ptr<const Matcher> matcher = loadMatcher<Matcher>(argv[SERVE_DATA_INDEX], &database, nullptr,
+                                                                  (int) std::thread::hardware_concurrency());
+    if(matcher == nullptr)
+    {
+        return 1;
+    }
+    database.close();
+    UnixSocketServer server(argv[SERVE_SOCKET_INDEX]);
+    if(!server.good())
+    {
+        std::cerr << IVALID_MSG << ": " << argv[SERVE_SOCKET_INDEX] << std::endl;
+        return 1;
+    }
+    AtomicSnapshot<Matcher> current(matcher);
+    std::signal(SIGHUP, requestReload);
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    DatabaseReloader<Matcher> reloader(argv[SERVE_DATA_INDEX], &current);
+    std::vector<typename Matcher::Scan> scans(1, makeScan(*matcher, threshold));
+    server.run([&](const char* request, size_t length, std::string* response)
+    {
+        refreshScans(current, &matcher, &scans, threshold);
+        int score = scoreMsg(request, length, &scans[0]);
+        *response += threshold <= score ? SPAM_MSG : NOT_SPAM_MSG;
+        *response += ' ' + std::to_string(score);
+        if(earlyExit)
+        {
+            *response += ' ' + (scans[0].skipped() ? EARLY_MSG : FULL_MSG);
+        }
+    }, stopRequested);
+    printMatcherStats(*matcher, argv[SERVE_DATA_INDEX]);
+    return 0;
+}
+
 /**
  * the main func of the program
  * @param argc the number of args
@@ -220,7 +1026,37 @@ int main(int argc, char *argv[])
 {
     std::ifstream database, msg;
     int threshold = 0;
-    HashMap<std::string, int> map;
+    while(argc > 1 && (std::string(argv[1]) == STATS_FLAG || std::string(argv[1]) == EARLY_FLAG ||
+                       std::string(argv[1]) == TOKENS_FLAG))
+    {
+        printStats = printStats || std::string(argv[1]) == STATS_FLAG;
+        earlyExit = earlyExit || std::string(argv[1]) == EARLY_FLAG;
+        if(std::string(argv[1]) == TOKENS_FLAG)
+        {
+            if(argc <= 2 || !isValidInt(&tokenWords, std::string(argv[2]), true) || tokenWords > TOKEN_WORDS_MAX)
+            {
+                std::cerr << USAGE_MSG << std::endl;
+                return 1;
+            }
+            argc--;
+            argv++;
+        }
+        // skip the option, so the rest of the args are where they are without it
+        argc--;
+        argv++;
+    }
+    if(argc > 1 && std::string(argv[1]) == BATCH_FLAG)
+    {
+        return tokenWords > 0 ? runBatch<TokenMatcher>(argc, argv) : runBatch<PhraseMatcher>(argc, argv);
+    }
+    if(argc > 1 && std::string(argv[1]) == COMPILE_COMMAND)
+    {
+        return runCompile(argc, argv);
+    }
+    if(argc > 1 && std::string(argv[1]) == SERVE_COMMAND)
+    {
+        return tokenWords > 0 ? runServe<TokenMatcher>(argc, argv) : runServe<PhraseMatcher>(argc, argv);
+    }
     if(!isValidArgs(argc))
     {
         return 1;
@@ -247,18 +1083,21 @@ int main(int argc, char *argv[])
         return 1;
     }
     int score = 0;
-    if(!parse(&database, &msg, &score, &map))
+    bool early = false;
+    bool parsed = tokenWords > 0 ? parse<TokenMatcher>(&database, &msg, argv[DATA_INDEX], argv[MSG_INDEX], threshold,
+                                                       &score, &early)
+                                 : parse<PhraseMatcher>(&database, &msg, argv[DATA_INDEX], argv[MSG_INDEX], threshold,
+                                                        &score, &early);
+    if(!parsed)
     {
         return 1;
     }
-    if(threshold <= score)
-    {
-        std::cout << SPAM_MSG << std::endl;
-    }
-    else
+    std::cout << (threshold <= score ? SPAM_MSG : NOT_SPAM_MSG);
+    if(earlyExit)
     {
-        std::cout << NOT_SPAM_MSG << std::endl;
+        std::cout << ' ' << (early ? EARLY_MSG : FULL_MSG);
     }
+    std::cout << std::endl;
     database.close();
     msg.close();
     return 0;
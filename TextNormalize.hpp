@@ -0,0 +1,305 @@
+#ifndef EX3_TEXTNORMALIZE_HPP
+#define EX3_TEXTNORMALIZE_HPP
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TEXT_NORMALIZE_X86 1
+#endif
+
+
+/// ###### text kernels #######
+/**
+ * the byte loops of the text normalization, one byte at a time. this is the fallback on every machine,
+ * and it also finishes the tail that is too short for a vector.
+ * only the ASCII letters are lowercased, the same as std::tolower in the "C" locale.
+ */
+struct TextScalar
+{
+    /**
+     * lowercase the ASCII letters in place
+     * @param data the chars
+     * @param length the number of chars
+     */
+    static void lowercase(char* data, size_t length)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            if (data[i] >= 'A' && data[i] <= 'Z')
+            {
+                data[i] = (char) (data[i] + ('a' - 'A'));
+            }
+        }
+    }
+
+    /**
+     * copy chars lowercased, without '\r', and with every '\n' replaced by lineEnd
+     * @param src the chars
+     * @param length the number of chars
+     * @param dst gets the normalized chars, room for length chars
+     * @param lineEnd the char that replaces '\n'
+     * @return the number of chars written to dst
+     */
+    static size_t normalizeLines(const char* src, size_t length, char* dst, char lineEnd)
+    {
+        size_t used = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            char c = src[i];
+            if (c == '\r')
+            {
+                continue;
+            }
+            dst[used++] = c == '\n' ? lineEnd : (c >= 'A' && c <= 'Z') ? (char) (c + ('a' - 'A')) : c;
+        }
+        return used;
+    }
+
+    /**
+     * @param data the chars
+     * @param length the number of chars
+     * @param c the char we count
+     * @return the number of times c is in the chars
+     */
+    static size_t count(const char* data, size_t length, char c)
+    {
+        size_t found = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            found += data[i] == c;
+        }
+        return found;
+    }
+};
+
+#ifdef TEXT_NORMALIZE_X86
+
+/**
+ * the text kernels on 16 byte SSE2 vectors, every x86-64 machine has them. a letter is found with one
+ * signed compare: adding 128 - 'A' moves 'A'..'Z' to the 26 smallest signed bytes.
+ */
+struct TextSse2
+{
+    static void lowercase(char* data, size_t length)
+    {
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*) (data + i));
+            _mm_storeu_si128((__m128i*) (data + i), _lower(v));
+        }
+        TextScalar::lowercase(data + i, length - i);
+    }
+
+    static size_t normalizeLines(const char* src, size_t length, char* dst, char lineEnd)
+    {
+        const __m128i cr = _mm_set1_epi8('\r'), nl = _mm_set1_epi8('\n'), end = _mm_set1_epi8(lineEnd);
+        size_t i = 0, used = 0;
+        for (; i + 16 <= length; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*) (src + i));
+            // a vector with a '\r' shrinks, it is done one byte at a time
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, cr)) != 0)
+            {
+                used += TextScalar::normalizeLines(src + i, 16, dst + used, lineEnd);
+                continue;
+            }
+            __m128i isNl = _mm_cmpeq_epi8(v, nl);
+            __m128i out = _mm_or_si128(_mm_andnot_si128(isNl, _lower(v)), _mm_and_si128(isNl, end));
+            _mm_storeu_si128((__m128i*) (dst + used), out);
+            used += 16;
+        }
+        return used + TextScalar::normalizeLines(src + i, length - i, dst + used, lineEnd);
+    }
+
+    static size_t count(const char* data, size_t length, char c)
+    {
+        const __m128i wanted = _mm_set1_epi8(c);
+        size_t i = 0, found = 0;
+        for (; i + 16 <= length; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*) (data + i));
+            found += (size_t) __builtin_popcount((unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(v, wanted)));
+        }
+        return found + TextScalar::count(data + i, length - i, c);
+    }
+
+private:
+
+    /**
+     * @param v 16 chars
+     * @return the chars with the ASCII letters lowercased
+     */
+    static __m128i _lower(__m128i v)
+    {
+        __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8((char) (128 - 'A')));
+        __m128i upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char) (-128 + 26)));
+        return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+    }
+};
+
+/**
+ * the text kernels on 32 byte AVX2 vectors, used only when the CPU has AVX2
+ */
+struct TextAvx2
+{
+    __attribute__((target("avx2"))) static void lowercase(char* data, size_t length)
+    {
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*) (data + i));
+            _mm256_storeu_si256((__m256i*) (data + i), _lower(v));
+        }
+        TextSse2::lowercase(data + i, length - i);
+    }
+
+    __attribute__((target("avx2"))) static size_t normalizeLines(const char* src, size_t length, char* dst,
+                                                                 char lineEnd)
+    {
+        const __m256i cr = _mm256_set1_epi8('\r'), nl = _mm256_set1_epi8('\n'), end = _mm256_set1_epi8(lineEnd);
+        size_t i = 0, used = 0;
+        for (; i + 32 <= length; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*) (src + i));
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, cr)) != 0)
+            {
+                used += TextSse2::normalizeLines(src + i, 32, dst + used, lineEnd);
+                continue;
+            }
+            __m256i out = _mm256_blendv_epi8(_lower(v), end, _mm256_cmpeq_epi8(v, nl));
+            _mm256_storeu_si256((__m256i*) (dst + used), out);
+            used += 32;
+        }
+        return used + TextSse2::normalizeLines(src + i, length - i, dst + used, lineEnd);
+    }
+
+    __attribute__((target("avx2,popcnt"))) static size_t count(const char* data, size_t length, char c)
+    {
+        const __m256i wanted = _mm256_set1_epi8(c);
+        size_t i = 0, found = 0;
+        for (; i + 32 <= length; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*) (data + i));
+            found += (size_t) __builtin_popcount((unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, wanted)));
+        }
+        return found + TextSse2::count(data + i, length - i, c);
+    }
+
+private:
+
+    __attribute__((target("avx2"))) static __m256i _lower(__m256i v)
+    {
+        __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8((char) (128 - 'A')));
+        __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8((char) (-128 + 26)), shifted);
+        return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+    }
+};
+
+#endif
+
+/**
+ * the text kernels of this machine, picked once on the first call
+ */
+struct TextKernels
+{
+    void (*lowercase)(char*, size_t);
+    size_t (*normalizeLines)(const char*, size_t, char*, char);
+    size_t (*count)(const char*, size_t, char);
+
+    /**
+     *
+     * @return the fastest kernels that the CPU supports
+     */
+    static const TextKernels& get()
+    {
+        static const TextKernels kernels = _pick();
+        return kernels;
+    }
+
+private:
+
+    static TextKernels _pick()
+    {
+#ifdef TEXT_NORMALIZE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return {&TextAvx2::lowercase, &TextAvx2::normalizeLines, &TextAvx2::count};
+        }
+        return {&TextSse2::lowercase, &TextSse2::normalizeLines, &TextSse2::count};
+#else
+        return {&TextScalar::lowercase, &TextScalar::normalizeLines, &TextScalar::count};
+#endif
+    }
+};
+
+/// ### end of text kernels ###///
+
+
+/// ###### text normalization #######
+/**
+ * lowercase the ASCII letters in place
+ * @param data the chars
+ * @param length the number of chars
+ */
+inline void asciiLowercase(char* data, size_t length)
+{
+    TextKernels::get().lowercase(data, length);
+}
+
+/**
+ * copy chars lowercased, without '\r', and with every '\n' replaced by lineEnd
+ * @param src the chars
+ * @param length the number of chars
+ * @param dst gets the normalized chars, room for length chars, it may not overlap src
+ * @param lineEnd the char that replaces '\n'
+ * @return the number of chars written to dst
+ */
+inline size_t normalizeLines(const char* src, size_t length, char* dst, char lineEnd)
+{
+    return TextKernels::get().normalizeLines(src, length, dst, lineEnd);
+}
+
+/**
+ * @param data the chars
+ * @param length the number of chars
+ * @param c the char we count
+ * @return the number of times c is in the chars
+ */
+inline size_t countByte(const char* data, size_t length, char c)
+{
+    return TextKernels::get().count(data, length, c);
+}
+
+/**
+ * remove every '\r' in place. the first '\r' is found with memchr (vectorized by the C library), so a
+ * text without any costs a single scan
+ * @param data the chars
+ * @param length the number of chars
+ * @return the number of chars that are left
+ */
+inline size_t removeCR(char* data, size_t length)
+{
+    char* cr = (char*) std::memchr(data, '\r', length);
+    if (cr == nullptr)
+    {
+        return length;
+    }
+    size_t used = (size_t) (cr - data);
+    for (size_t i = used + 1; i < length; i++)
+    {
+        if (data[i] != '\r')
+        {
+            data[used++] = data[i];
+        }
+    }
+    return used;
+}
+
+/// ### end of text normalization ###///
+
+
+#endif //EX3_TEXTNORMALIZE_HPP
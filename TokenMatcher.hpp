@@ -0,0 +1,467 @@
+#ifndef EX3_TOKENMATCHER_HPP
+#define EX3_TOKENMATCHER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include "HashMap.hpp"
+#include "PhraseMatcher.hpp"
+
+#define TOKEN_SEPARATE ' '
+#define TOKEN_FILTER_RATE 0.01
+
+
+/**
+ * this class reprasents the phrases of a spam database as word n-grams. a message is split into words (runs of
+ * ASCII letters and digits and of non ASCII bytes, everything else is a word boundary) and every run of 1 to k
+ * words that are next to each other is looked up in a hash map of the phrases. so "free" matches the word "free"
+ * and not the inside of "freedom", and a message costs (number of words * k) lookups whatever the size of the
+ * database. most runs of words are not phrases, so the hash map has a filter that answers them.
+ * a phrase is split the same way and its words are joined by single spaces, "free  money!" is the phrase
+ * "free money" and matches "Free money" or "free, money" in a message. a phrase with no words or with more than
+ * k words never matches, and phrases that are the same words have their values added.
+ * the score of a message is the sum of count * value over all the phrases, where count is the number of non
+ * overlapping occurrences (in words) of the phrase, counted from left to right, like in PhraseMatcher.
+ * the matcher is immutable after it is built, so many Scan objects can use it at once.
+ */
+class TokenMatcher
+{
+private:
+
+    /** the phrases, their words joined by single spaces, to their index */
+    HashMap<std::string, int, ChainedBuckets, FastStringHash> _index;
+
+    /** the value of every phrase */
+    std::vector<int> _value;
+
+    /** the most words of a phrase, the k of the n-grams */
+    int _words;
+
+    /** the length of the longest phrase, a word longer than it is in no phrase */
+    size_t _longest;
+
+    /** the smallest value of a phrase, 0 when there are no phrases */
+    int64_t _minValue;
+
+    /** the most that the end of one word can add to the score */
+    int64_t _maxGain;
+
+    /**
+     * @param c a char of a lowercased message
+     * @return true if the char is a part of a word, false if it is a word boundary
+     */
+    static bool _isWordChar(unsigned char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+    }
+
+    /**
+     * add a phrase of the database
+     * @param phrase the phrase as it is in the database
+     * @param value the value of the phrase
+     */
+    void _add(std::string_view phrase, int value)
+    {
+        std::string words;
+        int count = 0;
+        bool inWord = false;
+        for (char c : phrase)
+        {
+            if (_isWordChar((unsigned char) c))
+            {
+                if (!inWord && !words.empty())
+                {
+                    words += TOKEN_SEPARATE;
+                }
+                count += !inWord;
+                inWord = true;
+                words += c;
+            }
+            else
+            {
+                inWord = false;
+            }
+        }
+        if (count == 0 || count > _words)
+        {
+            return;
+        }
+        auto found = _index.find(words);
+        if (found != _index.end())
+        {
+            _value[found->second] += value;
+            return;
+        }
+        _index.insert(std::move(words), (int) _value.size());
+        _value.push_back(value);
+    }
+
+    /**
+     * compute the bounds of the early exit, once all the phrases were added. the end of a word looks up the runs
+     * of 1 to k words that end with it, and a run of n words is at most the biggest phrase of n words
+     */
+    void _finish()
+    {
+        std::vector<int64_t> biggest((size_t) _words + 1, 0);
+        _longest = 0;
+        _minValue = 0;
+        for (const auto& pair : _index)
+        {
+            int value = _value[pair.second];
+            size_t words = (size_t) std::count(pair.first.begin(), pair.first.end(), TOKEN_SEPARATE) + 1;
+            biggest[words] = std::max(biggest[words], (int64_t) value);
+            _longest = std::max(_longest, pair.first.size());
+            _minValue = std::min(_minValue, (int64_t) value);
+        }
+        _maxGain = 0;
+        for (int64_t value : biggest)
+        {
+            _maxGain += value;
+        }
+        _index.setFilter(TOKEN_FILTER_RATE);
+        // the stats of the index count the lookups of the messages only
+        _index.resetStats();
+    }
+
+public:
+
+    /**
+     * Build the matcher from a database
+     * @param database a map from a phrase to its value, for example HashMap<std::string, int>
+     * @param words the most words of a phrase that is looked up, the k of the n-grams
+     */
+    template <class Map>
+    TokenMatcher(const Map& database, int words) : _words(words)
+    {
+        _index.reserve((int) database.size());
+        for (const auto& pair : database)
+        {
+            _add(pair.first, pair.second);
+        }
+        _finish();
+    }
+
+    /**
+     * Build the matcher from the phrases of an automaton, for example of a snapshot that was mapped
+     * @param automaton the automaton
+     * @param words the most words of a phrase that is looked up, the k of the n-grams
+     */
+    TokenMatcher(const PhraseMatcher& automaton, int words) : _words(words)
+    {
+        _index.reserve(automaton.phrases());
+        for (int phrase = 0; phrase < automaton.phrases(); phrase++)
+        {
+            _add(automaton.phrase(phrase), automaton.value(phrase));
+        }
+        _finish();
+    }
+
+    TokenMatcher(const TokenMatcher&) = delete;
+
+    TokenMatcher& operator=(const TokenMatcher&) = delete;
+
+    /**
+     *
+     * @return the number of phrases that can match, the phrases of the database without the ones with no words
+     * or too many words
+     */
+    int phrases() const { return (int) _value.size(); }
+
+    /**
+     *
+     * @return the most words of a phrase that is looked up
+     */
+    int words() const { return _words; }
+
+    /**
+     *
+     * @return true if no phrase has a negative value, so a scan can stop once it reaches a threshold
+     */
+    bool monotonic() const { return _minValue >= 0; }
+
+    /**
+     *
+     * @return the most that the end of one word can add to the score
+     */
+    int64_t maxGain() const { return _maxGain; }
+
+    /**
+     *
+     * @return the stats of the hash map of the phrases
+     */
+    HashMapStats stats() const { return _index.stats(); }
+
+    /**
+     * the state of scoring one message, the message can be fed in pieces, a word that is split between
+     * two pieces is still one word. it has the interface of PhraseMatcher::Scan
+     */
+    class Scan
+    {
+    private:
+
+        /** the matcher */
+        const TokenMatcher* _matcher;
+
+        /** the last words of the message, joined by single spaces, the n-grams are looked up in it */
+        std::string _text;
+
+        /** where the last k words start in _text, the oldest first */
+        std::vector<size_t> _starts;
+
+        /** true while the chars are of a word */
+        bool _inWord;
+
+        /** true if the current word got longer than any phrase, it is not kept */
+        bool _tooLong;
+
+        /** the number of chars that were fed */
+        size_t _position;
+
+        /** the number of words that ended */
+        size_t _wordCount;
+
+        /** the score so far */
+        int _score;
+
+        /** for every phrase, the word count after its last counted occurrence */
+        std::vector<size_t> _lastEnd;
+
+        /** the phrases that have a counted occurrence, only their _lastEnd is cleared by reset */
+        std::vector<int> _counted;
+
+        /** the score that the scan stops at, LLONG_MAX when it never stops */
+        long long _stopAt;
+
+        /** the number of chars of the message, SIZE_MAX when it is not known */
+        size_t _length;
+
+        /** true if chars of the message were not scanned since the verdict was already known */
+        bool _skipped;
+
+        /**
+         * a word starts
+         */
+        void _startWord()
+        {
+            if (!_text.empty())
+            {
+                _text += TOKEN_SEPARATE;
+            }
+            _starts.push_back(_text.size());
+            _inWord = true;
+        }
+
+        /**
+         * a word ended, look up the runs of 1 to k words that end with it
+         */
+        void _endWord();
+
+    public:
+
+        /**
+         * start scoring a message
+         * @param matcher the matcher
+         */
+        explicit Scan(const TokenMatcher& matcher) : _matcher(&matcher), _inWord(false), _tooLong(false),
+                                                    _position(0), _wordCount(0), _score(0),
+                                                    _lastEnd(matcher._value.size(), 0), _stopAt(LLONG_MAX),
+                                                    _length(SIZE_MAX), _skipped(false)
+        {
+        }
+
+        /**
+         * feed the next chars of the message
+         * @param data the chars
+         * @param length the number of chars
+         */
+        void feed(const char* data, size_t length);
+
+        /**
+         *
+         * @return the score of the words that ended so far
+         */
+        int score() const { return _score; }
+
+        /**
+         * stop scanning a message once its score reaches the threshold, see PhraseMatcher::Scan::stopAt
+         * @param threshold the score that decides the verdict
+         */
+        void stopAt(int threshold)
+        {
+            if (_matcher->monotonic())
+            {
+                _stopAt = threshold;
+            }
+        }
+
+        /**
+         * the number of chars of the message, see PhraseMatcher::Scan::expectLength
+         * @param length the number of chars that will be fed at most
+         */
+        void expectLength(size_t length) { _length = length; }
+
+        /**
+         *
+         * @return true if the scan stops at a threshold and the verdict is known: the score reached the
+         * threshold, or even if every word that can still end added maxGain() the score would stay below it.
+         * a word that ends takes a boundary char, and a word that starts takes one more
+         */
+        bool decided() const
+        {
+            if (_score >= _stopAt)
+            {
+                return true;
+            }
+            if (_stopAt == LLONG_MAX || _length == SIZE_MAX)
+            {
+                return false;
+            }
+            uint64_t left = _length > _position ? _length - _position : 0;
+            uint64_t ends = (_inWord ? 1 : 0) + left / 2;
+            int64_t gain = _matcher->maxGain();
+            return gain == 0 || ends <= (uint64_t) ((_stopAt - _score - 1) / gain);
+        }
+
+        /**
+         *
+         * @return true if chars of the message were not scanned, since the verdict was known before them
+         */
+        bool skipped() const { return _skipped; }
+
+        /**
+         * start scoring a new message with the same scan, without allocating again
+         */
+        void reset()
+        {
+            for (int phrase : _counted)
+            {
+                _lastEnd[phrase] = 0;
+            }
+            _counted.clear();
+            _text.clear();
+            _starts.clear();
+            _inWord = false;
+            _tooLong = false;
+            _position = 0;
+            _wordCount = 0;
+            _score = 0;
+            _length = SIZE_MAX;
+            _skipped = false;
+        }
+    };
+};
+
+
+/**
+ * a word ended, look up the runs of 1 to k words that end with it
+ */
+inline void TokenMatcher::Scan::_endWord()
+{
+    const TokenMatcher& matcher = *_matcher;
+    _inWord = false;
+    _wordCount++;
+    if (_tooLong)
+    {
+        // no phrase has the word, so no run of words across it is a phrase either
+        _tooLong = false;
+        _text.clear();
+        _starts.clear();
+        return;
+    }
+    std::string_view text(_text);
+    size_t end = _text.size();
+    for (size_t words = 1; words <= _starts.size(); words++)
+    {
+        size_t start = _starts[_starts.size() - words];
+        if (end - start > matcher._longest)
+        {
+            break;
+        }
+        auto found = matcher._index.find(text.substr(start, end - start));
+        if (found == matcher._index.end())
+        {
+            continue;
+        }
+        int phrase = found->second;
+        // an occurrence is counted only if it starts after the last counted one of the same phrase ended
+        if (_wordCount - words >= _lastEnd[phrase])
+        {
+            if (_lastEnd[phrase] == 0)
+            {
+                _counted.push_back(phrase);
+            }
+            _lastEnd[phrase] = _wordCount;
+            _score += matcher._value[phrase];
+        }
+    }
+    if ((int) _starts.size() == matcher._words)
+    {
+        _starts.erase(_starts.begin());
+    }
+    // drop the words that no run will start at, once they are most of the text
+    if (!_starts.empty() && _starts.front() > _text.size() / 2)
+    {
+        size_t dropped = _starts.front();
+        _text.erase(0, dropped);
+        for (size_t& start : _starts)
+        {
+            start -= dropped;
+        }
+    }
+    else if (_starts.empty())
+    {
+        _text.clear();
+    }
+}
+
+/**
+ * feed the next chars of the message
+ * @param data the chars
+ * @param length the number of chars
+ */
+inline void TokenMatcher::Scan::feed(const char* data, size_t length)
+{
+    if (decided())
+    {
+        _skipped = _skipped || length > 0;
+        return;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char c = (unsigned char) data[i];
+        _position++;
+        if (_isWordChar(c))
+        {
+            if (!_inWord)
+            {
+                _startWord();
+            }
+            if (_text.size() - _starts.back() >= _matcher->_longest)
+            {
+                _tooLong = true;
+            }
+            else
+            {
+                _text += (char) c;
+            }
+            continue;
+        }
+        if (!_inWord)
+        {
+            continue;
+        }
+        _endWord();
+        if (_score >= _stopAt)
+        {
+            _skipped = i + 1 < length;
+            return;
+        }
+    }
+}
+
+
+#endif //EX3_TOKENMATCHER_HPP
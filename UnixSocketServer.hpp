@@ -0,0 +1,386 @@
+#ifndef EX3_UNIXSOCKETSERVER_HPP
+#define EX3_UNIXSOCKETSERVER_HPP
+
+#include <string>
+#include <functional>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include "HashMap.hpp"
+
+
+#define SERVER_BACKLOG 128
+#define SERVER_MAX_EVENTS 64
+#define SERVER_POLL_MS 100
+#define SERVER_READ_CHUNK 65536
+#define SERVER_MAX_REQUEST (64 << 20)
+#define SERVER_MAX_PENDING (1 << 20)
+#define FRAME_HEADER 4
+
+
+/**
+ * this class reprasents a server on a Unix domain stream socket with an epoll event loop on one thread.
+ * the protocol is length prefixed both ways: a frame is a 4 byte big endian length and then that many
+ * bytes. a client may pipeline requests, send many frames without waiting, and gets a response frame for
+ * every request frame in the order of the requests.
+ * a connection whose request is longer than SERVER_MAX_REQUEST is closed, and a connection whose client
+ * does not read its responses is not read from while more than SERVER_MAX_PENDING bytes wait for it.
+ */
+class UnixSocketServer
+{
+public:
+
+    /** gets a request and appends its response */
+    using Handler = std::function<void(const char* request, size_t length, std::string* response)>;
+
+private:
+
+    /** a client connection */
+    struct Connection
+    {
+        /** the bytes that were read and not handled yet, from consumed on */
+        std::string input;
+        size_t consumed = 0;
+
+        /** the responses that were not written yet, from written on */
+        std::string output;
+        size_t written = 0;
+
+        /** true once the client shut its side, the connection closes when the responses are written */
+        bool readClosed = false;
+
+        /** the events that the connection is registered for */
+        uint32_t events = EPOLLIN;
+    };
+
+    /** the path of the socket */
+    std::string _path;
+
+    /** the listening socket, -1 if it could not be made */
+    int _listener;
+
+    /** the epoll instance */
+    int _epoll;
+
+    /** the open connections by their socket */
+    HashMap<int, Connection> _connections;
+
+    /**
+     * @param data 4 bytes
+     * @return the big endian number in them
+     */
+    static uint32_t _readLength(const char* data)
+    {
+        const unsigned char* bytes = (const unsigned char*) data;
+        return (uint32_t) bytes[0] << 24 | (uint32_t) bytes[1] << 16 | (uint32_t) bytes[2] << 8 | bytes[3];
+    }
+
+    /**
+     * append a response frame to the output of a connection
+     * @param connection the connection
+     * @param handler the handler that makes the response
+     * @param request the request
+     * @param length the length of the request
+     */
+    static void _respond(Connection* connection, const Handler& handler, const char* request, size_t length)
+    {
+        size_t header = connection->output.size();
+        connection->output.append(FRAME_HEADER, '\0');
+        handler(request, length, &connection->output);
+        uint32_t size = (uint32_t) (connection->output.size() - header - FRAME_HEADER);
+        for (int i = 0; i < FRAME_HEADER; i++)
+        {
+            connection->output[header + i] = (char) (size >> (8 * (FRAME_HEADER - 1 - i)));
+        }
+    }
+
+    /**
+     * accept all the clients that wait
+     */
+    void _accept()
+    {
+        while (true)
+        {
+            int client = accept4(_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (client < 0)
+            {
+                return;
+            }
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = client;
+            if (epoll_ctl(_epoll, EPOLL_CTL_ADD, client, &event) != 0)
+            {
+                close(client);
+                continue;
+            }
+            _connections.insert(client, Connection());
+        }
+    }
+
+    /**
+     * close a connection
+     * @param fd its socket
+     */
+    void _close(int fd)
+    {
+        epoll_ctl(_epoll, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        _connections.erase(fd);
+    }
+
+    /**
+     * read one chunk of what the client sent. the events are level triggered, so a connection that sent
+     * more is served again by the next epoll_wait, after the other connections that are ready
+     * @param fd the socket
+     * @param connection the connection
+     * @return false if the connection failed
+     */
+    static bool _read(int fd, Connection* connection)
+    {
+        if (connection->readClosed || connection->output.size() - connection->written > SERVER_MAX_PENDING)
+        {
+            return true;
+        }
+        size_t used = connection->input.size();
+        connection->input.resize(used + SERVER_READ_CHUNK);
+        ssize_t got;
+        do
+        {
+            got = recv(fd, &connection->input[used], SERVER_READ_CHUNK, 0);
+        } while (got < 0 && errno == EINTR);
+        connection->input.resize(used + (got > 0 ? (size_t) got : 0));
+        if (got == 0)
+        {
+            connection->readClosed = true;
+        }
+        return got >= 0 || errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    /**
+     * @param connection the connection
+     * @return true if a whole request frame was read and not handled yet
+     */
+    static bool _hasFrame(const Connection* connection)
+    {
+        size_t left = connection->input.size() - connection->consumed;
+        return left >= FRAME_HEADER &&
+               left - FRAME_HEADER >= _readLength(connection->input.data() + connection->consumed);
+    }
+
+    /**
+     * handle the complete request frames that were read, while the responses that wait are not too many
+     * @param connection the connection
+     * @param handler the handler of the requests
+     * @return false if a request is too long
+     */
+    static bool _handle(Connection* connection, const Handler& handler)
+    {
+        while (connection->output.size() - connection->written <= SERVER_MAX_PENDING &&
+               connection->input.size() - connection->consumed >= FRAME_HEADER)
+        {
+            uint32_t length = _readLength(connection->input.data() + connection->consumed);
+            if (length > SERVER_MAX_REQUEST)
+            {
+                return false;
+            }
+            if (connection->input.size() - connection->consumed - FRAME_HEADER < length)
+            {
+                break;
+            }
+            _respond(connection, handler, connection->input.data() + connection->consumed + FRAME_HEADER, length);
+            connection->consumed += FRAME_HEADER + length;
+        }
+        // drop the handled bytes once they are most of the buffer, so a long pipeline is not copied again and again
+        if (connection->consumed > connection->input.size() / 2)
+        {
+            connection->input.erase(0, connection->consumed);
+            connection->consumed = 0;
+        }
+        return true;
+    }
+
+    /**
+     * write the responses that wait, until the socket is full
+     * @param fd the socket
+     * @param connection the connection
+     * @return false if the connection failed
+     */
+    static bool _write(int fd, Connection* connection)
+    {
+        while (connection->written < connection->output.size())
+        {
+            ssize_t sent = send(fd, connection->output.data() + connection->written,
+                                connection->output.size() - connection->written, MSG_NOSIGNAL);
+            if (sent >= 0)
+            {
+                connection->written += (size_t) sent;
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            if (errno != EINTR)
+            {
+                return false;
+            }
+        }
+        if (connection->written > connection->output.size() / 2)
+        {
+            connection->output.erase(0, connection->written);
+            connection->written = 0;
+        }
+        return true;
+    }
+
+    /**
+     * serve a connection that has events: read, handle, write, and register for the events it waits for
+     * @param fd the socket
+     * @param handler the handler of the requests
+     */
+    void _serve(int fd, const Handler& handler)
+    {
+        auto found = _connections.find(fd);
+        if (found == _connections.end())
+        {
+            return;
+        }
+        Connection* connection = &found->second;
+        if (!_read(fd, connection))
+        {
+            _close(fd);
+            return;
+        }
+        // _handle stops at too many waiting responses. once they are all written, the frames that are left are
+        // handled now, no event would come for them if the client sent everything (or shut its side) already
+        do
+        {
+            if (!_handle(connection, handler) || !_write(fd, connection))
+            {
+                _close(fd);
+                return;
+            }
+        } while (connection->output.size() == connection->written && _hasFrame(connection));
+        bool pending = connection->output.size() != connection->written;
+        if (connection->readClosed && !pending)
+        {
+            // all the responses were written (a request that the client cut in the middle gets none)
+            _close(fd);
+            return;
+        }
+        // while responses wait for the client, wait until it can take more, and stop reading if they are many
+        bool full = connection->output.size() - connection->written > SERVER_MAX_PENDING;
+        uint32_t events = (pending ? (uint32_t) EPOLLOUT : 0) | (connection->readClosed || full ? 0 : (uint32_t) EPOLLIN);
+        if (events != connection->events)
+        {
+            epoll_event event{};
+            event.events = events;
+            event.data.fd = fd;
+            epoll_ctl(_epoll, EPOLL_CTL_MOD, fd, &event);
+            connection->events = events;
+        }
+    }
+
+public:
+
+    /**
+     * Construct a server that listens on a socket path. a socket file that is left at the path (by a
+     * server that did not exit cleanly) is replaced, any other file there is kept and the server is not good
+     * @param path the path of the socket
+     */
+    explicit UnixSocketServer(const std::string& path) : _path(path), _listener(-1), _epoll(-1)
+    {
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            return;
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        struct stat existing{};
+        if (lstat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode))
+        {
+            unlink(path.c_str());
+        }
+        _listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        _epoll = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = _listener;
+        if (_listener < 0 || _epoll < 0 || bind(_listener, (const sockaddr*) &address, sizeof(address)) != 0 ||
+            listen(_listener, SERVER_BACKLOG) != 0 || epoll_ctl(_epoll, EPOLL_CTL_ADD, _listener, &event) != 0)
+        {
+            if (_listener >= 0)
+            {
+                close(_listener);
+            }
+            _listener = -1;
+        }
+    }
+
+    UnixSocketServer(const UnixSocketServer&) = delete;
+
+    UnixSocketServer& operator=(const UnixSocketServer&) = delete;
+
+    /**
+     * close the connections and the socket, and remove the socket file
+     */
+    ~UnixSocketServer()
+    {
+        for (const auto& connection : _connections)
+        {
+            close(connection.first);
+        }
+        if (_listener >= 0)
+        {
+            close(_listener);
+            unlink(_path.c_str());
+        }
+        if (_epoll >= 0)
+        {
+            close(_epoll);
+        }
+    }
+
+    /**
+     *
+     * @return true if the server listens
+     */
+    bool good() const { return _listener >= 0; }
+
+    /**
+     * serve the clients until stop is set, it is checked at least every SERVER_POLL_MS
+     * @param handler the handler of the requests, it runs on this thread
+     * @param stop set (for example by a signal handler) to return
+     */
+    void run(const Handler& handler, const std::atomic<bool>& stop)
+    {
+        epoll_event events[SERVER_MAX_EVENTS];
+        while (!stop.load())
+        {
+            int ready = epoll_wait(_epoll, events, SERVER_MAX_EVENTS, SERVER_POLL_MS);
+            for (int i = 0; i < ready; i++)
+            {
+                if (events[i].data.fd == _listener)
+                {
+                    _accept();
+                }
+                else
+                {
+                    _serve(events[i].data.fd, handler);
+                }
+            }
+        }
+    }
+};
+
+
+#endif //EX3_UNIXSOCKETSERVER_HPP
@@ -0,0 +1,207 @@
+#ifndef EX3_WORKSTEALINGPOOL_HPP
+#define EX3_WORKSTEALINGPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+/**
+ * this class reprasents a fixed pool of threads with a queue of tasks per thread. submitted tasks are
+ * spread over the queues, every thread takes the tasks of its own queue from the front, and a thread
+ * that ran out of tasks steals from the back of the queues of the other threads, so a few long tasks
+ * do not leave the rest of the threads idle.
+ * a task gets the index of the thread that runs it, so it can use state that belongs to that thread
+ * only (for example a PhraseMatcher::Scan per thread).
+ */
+class WorkStealingPool
+{
+public:
+
+    using Task = std::function<void(int)>;
+
+private:
+
+    /**
+     * the queue of tasks of one thread
+     */
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    /** the queue of every thread */
+    std::vector<std::unique_ptr<Queue>> _queues;
+
+    /** the threads */
+    std::vector<std::thread> _workers;
+
+    /** guards the counters below */
+    std::mutex _lock;
+
+    /** wakes a thread when a task is submitted or the pool stops */
+    std::condition_variable _wake;
+
+    /** wakes wait() when the last task is done */
+    std::condition_variable _idle;
+
+    /** the number of tasks in the queues */
+    int _queued;
+
+    /** the number of tasks that were submitted and are not done yet */
+    int _unfinished;
+
+    /** the queue that gets the next submitted task */
+    size_t _nextQueue;
+
+    /** true when the threads should exit */
+    bool _stop;
+
+    /**
+     * take a task, from the front of the own queue or else from the back of another queue
+     * @param worker the index of the thread
+     * @param task the task that was taken
+     * @return true if a task was taken, false if all the queues are empty
+     */
+    bool _take(int worker, Task& task)
+    {
+        size_t count = _queues.size();
+        for (size_t i = 0; i < count; i++)
+        {
+            Queue& queue = *_queues[(worker + i) % count];
+            std::unique_lock<std::mutex> guard(queue.lock);
+            if (queue.tasks.empty())
+            {
+                continue;
+            }
+            if (i == 0)
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            else
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            guard.unlock();
+            std::lock_guard<std::mutex> counters(_lock);
+            _queued--;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * the loop of every thread
+     * @param worker the index of the thread
+     */
+    void _run(int worker)
+    {
+        Task task;
+        while (true)
+        {
+            if (_take(worker, task))
+            {
+                task(worker);
+                task = nullptr;
+                std::lock_guard<std::mutex> counters(_lock);
+                if (--_unfinished == 0)
+                {
+                    _idle.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> counters(_lock);
+            _wake.wait(counters, [this] { return _stop || _queued > 0; });
+            if (_stop && _queued == 0)
+            {
+                return;
+            }
+        }
+    }
+
+public:
+
+    /**
+     * start the threads
+     * @param threads the number of threads, at least 1
+     */
+    explicit WorkStealingPool(int threads) : _queued(0), _unfinished(0), _nextQueue(0), _stop(false)
+    {
+        threads = threads < 1 ? 1 : threads;
+        for (int i = 0; i < threads; i++)
+        {
+            _queues.push_back(std::make_unique<Queue>());
+        }
+        for (int i = 0; i < threads; i++)
+        {
+            _workers.emplace_back(&WorkStealingPool::_run, this, i);
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * run the tasks that are left and join the threads
+     */
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> counters(_lock);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     *
+     * @return the number of threads in the pool
+     */
+    int threads() const { return (int) _workers.size(); }
+
+    /**
+     * submit a task to the pool
+     * @param task the task, it gets the index of the thread that runs it, in [0, threads())
+     */
+    void submit(Task task)
+    {
+        Queue& queue = *_queues[_nextQueue];
+        _nextQueue = (_nextQueue + 1) % _queues.size();
+        {
+            // the counters are held across the push, so a thread that takes the task early waits for them and never
+            // sees _queued or _unfinished below 0, and a thread that sees _queued > 0 finds the task in a queue
+            std::lock_guard<std::mutex> counters(_lock);
+            {
+                std::lock_guard<std::mutex> guard(queue.lock);
+                queue.tasks.push_back(std::move(task));
+            }
+            _queued++;
+            _unfinished++;
+        }
+        _wake.notify_one();
+    }
+
+    /**
+     * wait until every task that was submitted is done
+     */
+    void wait()
+    {
+        std::unique_lock<std::mutex> counters(_lock);
+        _idle.wait(counters, [this] { return _unfinished == 0; });
+    }
+};
+
+
+#endif //EX3_WORKSTEALINGPOOL_HPP
@@ -0,0 +1,349 @@
+#ifndef EX3_BENCHMARK_HPP
+#define EX3_BENCHMARK_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+
+#define BENCHMARK_MIN_TIME 0.2
+#define BENCHMARK_MAX_ITERATIONS 1000000000L
+#define BENCHMARK_GROWTH_CAP 10.0
+
+
+/// ###### benchmark runner #######
+/**
+ * keep a value alive, so the computation of a benchmark is not optimized away
+ * @param value the result of the computation
+ */
+template <class T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * the state of one run of a benchmark: the number of iterations to run, the timer, and what the
+ * iterations processed. a benchmark runs iterations() times and reports the items or bytes it went over.
+ */
+class BenchmarkState
+{
+private:
+
+    using Clock = std::chrono::steady_clock;
+
+    /** the number of iterations of this run */
+    long _iterations;
+
+    /** the time measured so far, without the paused parts */
+    double _seconds;
+
+    /** when the timer was last started */
+    Clock::time_point _start;
+
+    /** true while the timer runs */
+    bool _running;
+
+    /** the items processed by all the iterations */
+    double _items;
+
+    /** the bytes processed by all the iterations */
+    double _bytes;
+
+public:
+
+    /**
+     * @param iterations the number of iterations of this run
+     */
+    explicit BenchmarkState(long iterations) : _iterations(iterations), _seconds(0), _running(false), _items(0),
+                                               _bytes(0) {}
+
+    /**
+     *
+     * @return the number of iterations to run
+     */
+    long iterations() const { return _iterations; }
+
+    /**
+     * start (or continue) the timer
+     */
+    void resumeTiming()
+    {
+        if (!_running)
+        {
+            _start = Clock::now();
+            _running = true;
+        }
+    }
+
+    /**
+     * stop the timer, for a setup inside the iterations that should not be measured
+     */
+    void pauseTiming()
+    {
+        if (_running)
+        {
+            _seconds += std::chrono::duration<double>(Clock::now() - _start).count();
+            _running = false;
+        }
+    }
+
+    /**
+     * @param items the number of items all the iterations processed (keys, messages)
+     */
+    void setItemsProcessed(double items) { _items = items; }
+
+    /**
+     * @param bytes the number of bytes all the iterations processed
+     */
+    void setBytesProcessed(double bytes) { _bytes = bytes; }
+
+    /**
+     *
+     * @return the measured seconds
+     */
+    double seconds() const { return _seconds; }
+
+    /**
+     *
+     * @return the items processed
+     */
+    double items() const { return _items; }
+
+    /**
+     *
+     * @return the bytes processed
+     */
+    double bytes() const { return _bytes; }
+};
+
+/**
+ * this class reprasents a suite of named benchmarks, in the spirit of google benchmark: every benchmark
+ * runs with more and more iterations until it takes the minimum time, and it is reported in ns per
+ * iteration with its items and bytes per second.
+ * the command line options are --filter=<text> (run only the benchmarks whose name contains the text),
+ * --min-time=<seconds>, and --format=console|json|csv, json is the schema of google benchmark.
+ */
+class BenchmarkSuite
+{
+private:
+
+    /** a benchmark, timed by its state */
+    using Body = std::function<void(BenchmarkState&)>;
+
+    /** a finished benchmark */
+    struct Result
+    {
+        std::string name;
+        long iterations;
+        double nsPerIteration;
+        double itemsPerSecond;
+        double bytesPerSecond;
+    };
+
+    /** the benchmarks in the order they were added */
+    std::vector<std::pair<std::string, Body>> _benchmarks;
+
+    /** the finished benchmarks */
+    std::vector<Result> _results;
+
+    /** the text that the names of the benchmarks that run contain */
+    std::string _filter;
+
+    /** the minimum time of a benchmark */
+    double _minTime = BENCHMARK_MIN_TIME;
+
+    /** console, json or csv */
+    std::string _format = "console";
+
+    /**
+     * @param name the name of the benchmark
+     * @param body the benchmark
+     * @return the result of the run that took at least the minimum time
+     */
+    Result _run(const std::string& name, const Body& body) const
+    {
+        long iterations = 1;
+        while (true)
+        {
+            BenchmarkState state(iterations);
+            state.resumeTiming();
+            body(state);
+            state.pauseTiming();
+            if (state.seconds() >= _minTime || iterations >= BENCHMARK_MAX_ITERATIONS)
+            {
+                double seconds = std::max(state.seconds(), 1e-12);
+                return {name, iterations, seconds * 1e9 / (double) iterations, state.items() / seconds,
+                        state.bytes() / seconds};
+            }
+            // aim a little past the minimum time, and never grow too fast from a noisy short run
+            double factor = state.seconds() > 0 ? _minTime * 1.4 / state.seconds() : BENCHMARK_GROWTH_CAP;
+            factor = std::min(std::max(factor, 2.0), BENCHMARK_GROWTH_CAP);
+            iterations = std::min((long) ((double) iterations * factor), BENCHMARK_MAX_ITERATIONS);
+        }
+    }
+
+    /**
+     * @param value a rate
+     * @return the rate with a k / M / G suffix
+     */
+    static std::string _human(double value)
+    {
+        const char* suffixes[] = {"", "k", "M", "G", "T"};
+        int suffix = 0;
+        while (value >= 1000 && suffix < 4)
+        {
+            value /= 1000;
+            suffix++;
+        }
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(value < 10 ? 2 : 1) << value << suffixes[suffix];
+        return out.str();
+    }
+
+    /**
+     * @param text a name
+     * @return the name as a json string
+     */
+    static std::string _quote(const std::string& text)
+    {
+        std::string quoted = "\"";
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    void _printConsole(const Result& result) const
+    {
+        std::cout << std::left << std::setw(56) << result.name << std::right << std::setw(14) << std::fixed
+                  << std::setprecision(1) << result.nsPerIteration << " ns" << std::setw(12) << result.iterations;
+        if (result.itemsPerSecond > 0)
+        {
+            std::cout << "  items/s=" << _human(result.itemsPerSecond);
+        }
+        if (result.bytesPerSecond > 0)
+        {
+            std::cout << "  bytes/s=" << _human(result.bytesPerSecond);
+        }
+        std::cout << std::endl;
+    }
+
+    void _printJson() const
+    {
+        std::cout << "{\n  \"context\": {\"min_time\": " << _minTime << "},\n  \"benchmarks\": [";
+        for (size_t i = 0; i < _results.size(); i++)
+        {
+            const Result& result = _results[i];
+            std::cout << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << _quote(result.name)
+                      << ", \"iterations\": " << result.iterations << ", \"real_time\": " << std::fixed
+                      << std::setprecision(3) << result.nsPerIteration << ", \"time_unit\": \"ns\""
+                      << ", \"items_per_second\": " << result.itemsPerSecond
+                      << ", \"bytes_per_second\": " << result.bytesPerSecond << "}";
+        }
+        std::cout << "\n  ]\n}" << std::endl;
+    }
+
+    void _printCsv() const
+    {
+        std::cout << "name,iterations,real_time_ns,items_per_second,bytes_per_second" << std::endl;
+        for (const Result& result : _results)
+        {
+            std::cout << _quote(result.name) << "," << result.iterations << "," << std::fixed
+                      << std::setprecision(3) << result.nsPerIteration << "," << result.itemsPerSecond << ","
+                      << result.bytesPerSecond << std::endl;
+        }
+    }
+
+public:
+
+    /**
+     * read the options of the suite, the args that are not options are left for the benchmark
+     * @param argc the number of args, gets the number of args that are left
+     * @param argv the args, gets the args that are left
+     * @return false if an option is invalid
+     */
+    bool parseArgs(int* argc, char* argv[])
+    {
+        int left = 1;
+        for (int i = 1; i < *argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg.rfind("--filter=", 0) == 0)
+            {
+                _filter = arg.substr(strlen("--filter="));
+            }
+            else if (arg.rfind("--min-time=", 0) == 0)
+            {
+                _minTime = std::atof(arg.c_str() + strlen("--min-time="));
+            }
+            else if (arg.rfind("--format=", 0) == 0)
+            {
+                _format = arg.substr(strlen("--format="));
+                if (_format != "console" && _format != "json" && _format != "csv")
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                argv[left++] = argv[i];
+            }
+        }
+        *argc = left;
+        return _minTime > 0;
+    }
+
+    /**
+     * add a benchmark to the suite
+     * @param name the name of the benchmark, "group/case/size" like in google benchmark
+     * @param body runs state.iterations() iterations
+     */
+    void add(const std::string& name, Body body) { _benchmarks.emplace_back(name, std::move(body)); }
+
+    /**
+     * run the benchmarks that pass the filter, and print them
+     * @return the number of benchmarks that ran
+     */
+    int run()
+    {
+        for (const auto& benchmark : _benchmarks)
+        {
+            if (benchmark.first.find(_filter) == std::string::npos)
+            {
+                continue;
+            }
+            _results.push_back(_run(benchmark.first, benchmark.second));
+            if (_format == "console")
+            {
+                _printConsole(_results.back());
+            }
+        }
+        if (_format == "json")
+        {
+            _printJson();
+        }
+        else if (_format == "csv")
+        {
+            _printCsv();
+        }
+        return (int) _results.size();
+    }
+};
+
+/// ### end of benchmark runner ###///
+
+
+#endif //EX3_BENCHMARK_HPP
@@ -0,0 +1,387 @@
+/*******************************************include********************************************************************/
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+#include "HashMap.hpp"
+#include "Benchmark.hpp"
+
+/***********************************************define*****************************************************************/
+// benchmark suite of the HashMap against std::unordered_map: insert, lookup hit / miss, erase by key and through
+// it = map.erase(it) with the mutable iterator, const_iterator traversal and the cost of a resize, for int and std::string keys, at several sizes and load factors, with both
+// storage policies of the HashMap, and with the default policy behind a filter of FILTER_RATE false positives.
+// build: g++ -std=c++17 -O2 -I. benchmarks/ContainerBenchmark.cpp -o ContainerBenchmark
+// run:   ./ContainerBenchmark [--filter=<text>] [--min-time=<seconds>] [--format=console|json|csv]
+// names: <container>/<key>/<operation>/<size>/load:<upper load factor>
+
+#define SEED 2019
+#define FILTER_RATE 0.01
+
+/*************************************************methods**************************************************************/
+
+/// ###### containers #######
+/**
+ * the operations of a container that the benchmarks use, the containers differ only in these few
+ * functions. make(load) makes an empty map whose upper load factor (the max load factor of
+ * std::unordered_map) is load.
+ */
+template <class Map>
+struct MapOps;
+
+template <class KeyT, class ValueT, class Storage>
+struct MapOps<HashMap<KeyT, ValueT, Storage>>
+{
+    using Map = HashMap<KeyT, ValueT, Storage>;
+
+    static Map make(double load) { return Map(load / 3, load); }
+
+    static void insert(Map& map, const KeyT& key, const ValueT& value) { map.insert(key, value); }
+
+    static bool contains(const Map& map, const KeyT& key) { return map.containsKey(key); }
+
+    static void erase(Map& map, const KeyT& key) { map.erase(key); }
+
+    static void reserve(Map& map, int count) { map.reserve(count); }
+};
+
+/**
+ * a HashMap with a filter in front of its lookups
+ */
+template <class KeyT, class ValueT, class Storage>
+struct FilteredHashMap : HashMap<KeyT, ValueT, Storage>
+{
+    FilteredHashMap(double lowerLoadFactor, double upperLoadFactor) :
+            HashMap<KeyT, ValueT, Storage>(lowerLoadFactor, upperLoadFactor)
+    {
+        this->setFilter(FILTER_RATE);
+    }
+};
+
+template <class KeyT, class ValueT, class Storage>
+struct MapOps<FilteredHashMap<KeyT, ValueT, Storage>> : MapOps<HashMap<KeyT, ValueT, Storage>>
+{
+    using Map = FilteredHashMap<KeyT, ValueT, Storage>;
+
+    static Map make(double load) { return Map(load / 3, load); }
+};
+
+template <class KeyT, class ValueT>
+struct MapOps<std::unordered_map<KeyT, ValueT>>
+{
+    using Map = std::unordered_map<KeyT, ValueT>;
+
+    static Map make(double load)
+    {
+        Map map;
+        map.max_load_factor((float) load);
+        return map;
+    }
+
+    static void insert(Map& map, const KeyT& key, const ValueT& value) { map.emplace(key, value); }
+
+    static bool contains(const Map& map, const KeyT& key) { return map.find(key) != map.end(); }
+
+    static void erase(Map& map, const KeyT& key) { map.erase(key); }
+
+    static void reserve(Map& map, int count) { map.reserve((size_t) count); }
+};
+
+/// ### end of containers ###///
+
+
+/// ###### keys #######
+/**
+ * make distinct keys
+ * @param amount the number of keys
+ * @param salt keys of different salts never collide
+ * @return the keys, shuffled
+ */
+std::vector<int> makeKeys(int amount, int salt, int*)
+{
+    std::vector<int> keys((size_t) amount);
+    for (int i = 0; i < amount; i++)
+    {
+        // spread the keys, so they are not the identity sequence that std::hash maps to distinct buckets
+        keys[i] = (int) ((unsigned) (i * 2 + salt) * 2654435761u);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(SEED + salt));
+    return keys;
+}
+
+std::vector<std::string> makeKeys(int amount, int salt, std::string*)
+{
+    std::vector<std::string> keys;
+    keys.reserve((size_t) amount);
+    for (int i = 0; i < amount; i++)
+    {
+        keys.push_back((salt == 0 ? "buy cheap phrase " : "free money phrase ") + std::to_string(i));
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(SEED + salt));
+    return keys;
+}
+
+/// ### end of keys ###///
+
+
+/// ###### benchmarks #######
+/** the data of the group that runs now, the data of a group is freed when the next group starts */
+std::shared_ptr<void> currentData;
+
+/**
+ * the keys and the full map of one group of benchmarks (one container, key type, size and load factor),
+ * built when its first benchmark runs, so the benchmarks that are filtered out cost nothing
+ */
+template <class Map, class KeyT>
+class Fixture
+{
+private:
+
+    struct Data
+    {
+        std::vector<KeyT> present;
+        std::vector<KeyT> absent;
+        Map full;
+    };
+
+    int _size;
+    double _load;
+    std::weak_ptr<Data> _data;
+
+public:
+
+    Fixture(int size, double load) : _size(size), _load(load) {}
+
+    /**
+     *
+     * @return the data of the group, it stays alive until the next group builds its data
+     */
+    std::shared_ptr<Data> get()
+    {
+        std::shared_ptr<Data> data = _data.lock();
+        if (data == nullptr)
+        {
+            currentData.reset();
+            data = std::make_shared<Data>(Data{makeKeys(_size, 0, (KeyT*) nullptr),
+                                               makeKeys(_size, 1, (KeyT*) nullptr), MapOps<Map>::make(_load)});
+            for (const KeyT& key : data->present)
+            {
+                MapOps<Map>::insert(data->full, key, 1);
+            }
+            _data = data;
+            currentData = data;
+        }
+        return data;
+    }
+};
+
+/**
+ * add the benchmarks of one container and one key type at one size and load factor
+ * @param suite the suite
+ * @param prefix the name of the container and the key type
+ * @param size the number of keys in the map
+ * @param load the upper load factor
+ */
+template <class Map, class KeyT>
+void addMapBenchmarks(BenchmarkSuite* suite, const std::string& prefix, int size, double load)
+{
+    using Ops = MapOps<Map>;
+    std::ostringstream suffix;
+    suffix << "/" << size << "/load:" << load;
+    auto fixture = std::make_shared<Fixture<Map, KeyT>>(size, load);
+
+    suite->add(prefix + "/insert" + suffix.str(), [=](BenchmarkState& state)
+    {
+        state.pauseTiming();
+        auto data = fixture->get();
+        state.resumeTiming();
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            Map map = Ops::make(load);
+            for (const KeyT& key : data->present)
+            {
+                Ops::insert(map, key, 1);
+            }
+            doNotOptimize(map);
+        }
+        state.setItemsProcessed((double) state.iterations() * size);
+    });
+    suite->add(prefix + "/insert_reserved" + suffix.str(), [=](BenchmarkState& state)
+    {
+        state.pauseTiming();
+        auto data = fixture->get();
+        state.resumeTiming();
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            Map map = Ops::make(load);
+            Ops::reserve(map, size);
+            for (const KeyT& key : data->present)
+            {
+                Ops::insert(map, key, 1);
+            }
+            doNotOptimize(map);
+        }
+        state.setItemsProcessed((double) state.iterations() * size);
+    });
+    suite->add(prefix + "/lookup_hit" + suffix.str(), [=](BenchmarkState& state)
+    {
+        state.pauseTiming();
+        auto data = fixture->get();
+        state.resumeTiming();
+        long found = 0;
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            for (const KeyT& key : data->present)
+            {
+                found += Ops::contains(data->full, key);
+            }
+        }
+        doNotOptimize(found);
+        state.setItemsProcessed((double) state.iterations() * size);
+    });
+    suite->add(prefix + "/lookup_miss" + suffix.str(), [=](BenchmarkState& state)
+    {
+        state.pauseTiming();
+        auto data = fixture->get();
+        state.resumeTiming();
+        long found = 0;
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            for (const KeyT& key : data->absent)
+            {
+                found += Ops::contains(data->full, key);
+            }
+        }
+        doNotOptimize(found);
+        state.setItemsProcessed((double) state.iterations() * size);
+    });
+    suite->add(prefix + "/erase" + suffix.str(), [=](BenchmarkState& state)
+    {
+        state.pauseTiming();
+        auto data = fixture->get();
+        state.resumeTiming();
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            state.pauseTiming();
+            Map map = data->full;
+            state.resumeTiming();
+            for (const KeyT& key : data->present)
+            {
+                Ops::erase(map, key);
+            }
+            doNotOptimize(map);
+            // the copy is freed outside the timing too
+            state.pauseTiming();
+            map = Ops::make(load);
+            state.resumeTiming();
+        }
+        state.setItemsProcessed((double) state.iterations() * size);
+    });
+    suite->add(prefix + "/erase_iterator" + suffix.str(), [=](BenchmarkState& state)
+    {
+        state.pauseTiming();
+        auto data = fixture->get();
+        state.resumeTiming();
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            state.pauseTiming();
+            Map map = data->full;
+            state.resumeTiming();
+            for (auto it = map.begin(); it != map.end();)
+            {
+                it = map.erase(it);
+            }
+            if (map.size() != 0)
+            {
+                std::cerr << prefix << ": erase(iterator) left " << map.size() << " pairs" << std::endl;
+                std::exit(1);
+            }
+            state.pauseTiming();
+            map = Ops::make(load);
+            state.resumeTiming();
+        }
+        state.setItemsProcessed((double) state.iterations() * size);
+    });
+    suite->add(prefix + "/iterate" + suffix.str(), [=](BenchmarkState& state)
+    {
+        state.pauseTiming();
+        auto data = fixture->get();
+        state.resumeTiming();
+        const Map& map = data->full;
+        long sum = 0;
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            for (const auto& pair : map)
+            {
+                sum += pair.second;
+            }
+        }
+        doNotOptimize(sum);
+        state.setItemsProcessed((double) state.iterations() * size);
+    });
+    suite->add(prefix + "/resize" + suffix.str(), [=](BenchmarkState& state)
+    {
+        state.pauseTiming();
+        auto data = fixture->get();
+        state.resumeTiming();
+        // the cost of one resize alone: the full map is rehashed into a table 4 times bigger
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            state.pauseTiming();
+            Map map = data->full;
+            state.resumeTiming();
+            Ops::reserve(map, size * 4);
+            doNotOptimize(map);
+            state.pauseTiming();
+            map = Ops::make(load);
+            state.resumeTiming();
+        }
+        state.setItemsProcessed((double) state.iterations() * size);
+    });
+}
+
+/**
+ * add the benchmarks of all the containers for one key type
+ * @param suite the suite
+ * @param key the name of the key type
+ */
+template <class KeyT>
+void addKeyBenchmarks(BenchmarkSuite* suite, const std::string& key)
+{
+    for (int size : {1 << 10, 1 << 14, 1 << 18})
+    {
+        for (double load : {0.5, 0.75, 0.9})
+        {
+            addMapBenchmarks<HashMap<KeyT, int>, KeyT>(suite, "HashMap/" + key, size, load);
+            addMapBenchmarks<HashMap<KeyT, int, OpenAddressing>, KeyT>(suite, "HashMapOpen/" + key, size, load);
+            addMapBenchmarks<FilteredHashMap<KeyT, int, ChainedBuckets>, KeyT>(suite, "HashMapFiltered/" + key, size,
+                                                                               load);
+            addMapBenchmarks<std::unordered_map<KeyT, int>, KeyT>(suite, "unordered_map/" + key, size, load);
+        }
+    }
+}
+
+/// ### end of benchmarks ###///
+
+/**
+ * the main func of the benchmark
+ * @param argc the number of args
+ * @param argv the aray of args
+ * @return success
+ */
+int main(int argc, char* argv[])
+{
+    BenchmarkSuite suite;
+    if (!suite.parseArgs(&argc, argv) || argc != 1)
+    {
+        std::cerr << "Usage: ContainerBenchmark [--filter=<text>] [--min-time=<seconds>] "
+                     "[--format=console|json|csv]" << std::endl;
+        return 1;
+    }
+    addKeyBenchmarks<int>(&suite, "int");
+    addKeyBenchmarks<std::string>(&suite, "string");
+    suite.run();
+    return 0;
+}
@@ -0,0 +1,323 @@
+/*******************************************include********************************************************************/
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <filesystem>
+#include <cstdlib>
+#include <unistd.h>
+#include "HashMap.hpp"
+#include "PhraseMatcher.hpp"
+#include "TokenMatcher.hpp"
+#include "TextNormalize.hpp"
+#include "Benchmark.hpp"
+
+/***********************************************define*****************************************************************/
+// end to end benchmark of the spam detector on synthetic corpora: building the matcher, scoring messages in process
+// (the same normalization and Scan as SpamDetector, with the PhraseMatcher and with the TokenMatcher), and running the SpamDetector binary on a single message, in batch
+// mode over a directory of messages, and in batch mode on a compiled snapshot. the rates are messages and bytes of
+// messages per second. the binary cases run only when the path of a built SpamDetector is given.
+// build: g++ -std=c++17 -O2 -I. benchmarks/DetectorBenchmark.cpp -o DetectorBenchmark
+// run:   ./DetectorBenchmark [SpamDetector path] [--filter=<text>] [--min-time=<seconds>] [--format=console|json|csv]
+
+#define SEED 2019
+#define VOCABULARY 5000
+#define LINE_LENGTH 80
+#define PLANT_EVERY 40
+#define BATCH_MESSAGES_BYTES (1 << 22)
+#define MSG_BUFFER 4096
+#define THRESHOLD "50"
+#define TOKEN_WORDS 3
+
+/*************************************************methods**************************************************************/
+
+/// ###### corpus #######
+/**
+ * a synthetic corpus: the words, a database of phrases of 1 to 3 words, and messages of random words
+ * with lines of about LINE_LENGTH chars, where one word in PLANT_EVERY starts a phrase of the database
+ */
+class Corpus
+{
+private:
+
+    std::mt19937 _random;
+    std::vector<std::string> _words;
+    std::vector<std::pair<std::string, int>> _phrases;
+
+public:
+
+    /**
+     * @param phrases the number of phrases in the database
+     */
+    explicit Corpus(int phrases) : _random(SEED)
+    {
+        for (int i = 0; i < VOCABULARY; i++)
+        {
+            std::string word;
+            for (int length = 3 + (int) (_random() % 6); length > 0; length--)
+            {
+                word += (char) ('a' + _random() % 26);
+            }
+            _words.push_back(word);
+        }
+        HashMap<std::string, int> seen;
+        while ((int) _phrases.size() < phrases)
+        {
+            std::string phrase = _words[_random() % VOCABULARY];
+            for (int more = (int) (_random() % 3); more > 0; more--)
+            {
+                phrase += " " + _words[_random() % VOCABULARY];
+            }
+            if (seen.insert(phrase, 1))
+            {
+                _phrases.emplace_back(phrase, 1 + (int) (_random() % 5));
+            }
+        }
+    }
+
+    /**
+     *
+     * @return the phrases and their values
+     */
+    const std::vector<std::pair<std::string, int>>& phrases() const { return _phrases; }
+
+    /**
+     * @return the database text, "phrase,value" lines
+     */
+    std::string database() const
+    {
+        std::string text;
+        for (const auto& phrase : _phrases)
+        {
+            text += phrase.first + "," + std::to_string(phrase.second) + "\n";
+        }
+        return text;
+    }
+
+    /**
+     * @param bytes the size of the message
+     * @return a message, some of its words in upper case
+     */
+    std::string message(size_t bytes)
+    {
+        std::string msg;
+        size_t lineStart = 0;
+        while (msg.size() < bytes)
+        {
+            std::string word = _random() % PLANT_EVERY == 0 ? _phrases[_random() % _phrases.size()].first
+                                                            : _words[_random() % VOCABULARY];
+            if (_random() % 10 == 0)
+            {
+                word[0] = (char) (word[0] - 'a' + 'A');
+            }
+            msg += word;
+            if (msg.size() - lineStart > LINE_LENGTH)
+            {
+                msg += '\n';
+                lineStart = msg.size();
+            }
+            else
+            {
+                msg += ' ';
+            }
+        }
+        msg.resize(bytes);
+        return msg;
+    }
+};
+
+/// ### end of corpus ###///
+
+
+/// ###### benchmarks #######
+/**
+ * score a message the way SpamDetector does: lowercased, without '\r', every line ends with ','
+ * @param scan the scan, it is reset first
+ * @param msg the message
+ * @return the score
+ * @tparam Scan PhraseMatcher::Scan or TokenMatcher::Scan
+ */
+template <class Scan>
+int scoreMessage(Scan* scan, const std::string& msg)
+{
+    char buffer[MSG_BUFFER];
+    scan->reset();
+    for (size_t i = 0; i < msg.size(); i += MSG_BUFFER)
+    {
+        size_t used = normalizeLines(msg.data() + i, std::min(msg.size() - i, (size_t) MSG_BUFFER), buffer, ',');
+        scan->feed(buffer, used);
+    }
+    if (!msg.empty() && msg.back() != '\n')
+    {
+        scan->feed(",", 1);
+    }
+    return scan->score();
+}
+
+/**
+ * write a file
+ * @param path the path of the file
+ * @param text the content
+ */
+void writeFile(const std::filesystem::path& path, const std::string& text)
+{
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+/**
+ * run a command with its output thrown away
+ * @param command the command
+ * @return true if it exited with 0
+ */
+bool runQuiet(const std::string& command)
+{
+    return std::system((command + " > /dev/null 2>&1").c_str()) == 0;
+}
+
+/**
+ * add the benchmarks of one database size
+ * @param suite the suite
+ * @param phrases the number of phrases in the database
+ * @param detector the path of the SpamDetector binary, empty to skip the binary cases
+ * @param dir the directory of the corpora files
+ */
+void addDatabaseBenchmarks(BenchmarkSuite* suite, int phrases, const std::string& detector,
+                           const std::filesystem::path& dir)
+{
+    auto corpus = std::make_shared<Corpus>(phrases);
+    std::string name = "/" + std::to_string(phrases);
+    auto map = std::make_shared<HashMap<std::string, int>>();
+    for (const auto& phrase : corpus->phrases())
+    {
+        map->insert(phrase.first, phrase.second);
+    }
+    auto matcher = std::make_shared<PhraseMatcher>(*map);
+    auto tokens = std::make_shared<TokenMatcher>(*map, TOKEN_WORDS);
+
+    suite->add("matcher_build" + name, [=](BenchmarkState& state)
+    {
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            PhraseMatcher built(*map);
+            doNotOptimize(built);
+        }
+        state.setItemsProcessed((double) state.iterations() * phrases);
+    });
+    suite->add("token_matcher_build" + name, [=](BenchmarkState& state)
+    {
+        for (long i = 0; i < state.iterations(); i++)
+        {
+            TokenMatcher built(*map, TOKEN_WORDS);
+            doNotOptimize(built);
+        }
+        state.setItemsProcessed((double) state.iterations() * phrases);
+    });
+    for (size_t bytes : {(size_t) 256, (size_t) 1 << 16})
+    {
+        auto msgs = std::make_shared<std::vector<std::string>>();
+        for (size_t total = 0; total < BATCH_MESSAGES_BYTES; total += bytes)
+        {
+            msgs->push_back(corpus->message(bytes));
+        }
+        std::string size = "/" + std::to_string(bytes) + "B";
+        suite->add("scorer" + name + size, [=](BenchmarkState& state)
+        {
+            PhraseMatcher::Scan scan(*matcher);
+            long score = 0;
+            for (long i = 0; i < state.iterations(); i++)
+            {
+                score += scoreMessage(&scan, (*msgs)[(size_t) i % msgs->size()]);
+            }
+            doNotOptimize(score);
+            state.setItemsProcessed((double) state.iterations());
+            state.setBytesProcessed((double) state.iterations() * bytes);
+        });
+        suite->add("token_scorer" + name + size, [=](BenchmarkState& state)
+        {
+            TokenMatcher::Scan scan(*tokens);
+            long score = 0;
+            for (long i = 0; i < state.iterations(); i++)
+            {
+                score += scoreMessage(&scan, (*msgs)[(size_t) i % msgs->size()]);
+            }
+            doNotOptimize(score);
+            state.setItemsProcessed((double) state.iterations());
+            state.setBytesProcessed((double) state.iterations() * bytes);
+        });
+        if (detector.empty())
+        {
+            continue;
+        }
+        std::filesystem::path database = dir / ("db" + std::to_string(phrases) + ".txt");
+        std::filesystem::path snapshot = dir / ("db" + std::to_string(phrases) + ".snapshot");
+        std::filesystem::path msgDir = dir / ("msgs" + std::to_string(phrases) + "_" + std::to_string(bytes));
+        writeFile(database, corpus->database());
+        runQuiet("'" + detector + "' compile '" + database.string() + "' '" + snapshot.string() + "'");
+        std::filesystem::create_directories(msgDir);
+        for (size_t i = 0; i < msgs->size(); i++)
+        {
+            writeFile(msgDir / ("msg" + std::to_string(i) + ".txt"), (*msgs)[i]);
+        }
+        std::string single = "'" + detector + "' '" + database.string() + "' '" + (msgDir / "msg0.txt").string() +
+                             "' " + THRESHOLD;
+        suite->add("detector_single" + name + size, [=](BenchmarkState& state)
+        {
+            for (long i = 0; i < state.iterations(); i++)
+            {
+                runQuiet(single);
+            }
+            state.setItemsProcessed((double) state.iterations());
+            state.setBytesProcessed((double) state.iterations() * bytes);
+        });
+        for (const std::filesystem::path& source : {database, snapshot})
+        {
+            std::string batch = "'" + detector + "' --batch '" + source.string() + "' " + THRESHOLD + " '" +
+                                msgDir.string() + "'";
+            std::string kind = source == database ? "detector_batch" : "detector_batch_snapshot";
+            suite->add(kind + name + size + "x" + std::to_string(msgs->size()), [=](BenchmarkState& state)
+            {
+                for (long i = 0; i < state.iterations(); i++)
+                {
+                    runQuiet(batch);
+                }
+                state.setItemsProcessed((double) state.iterations() * msgs->size());
+                state.setBytesProcessed((double) state.iterations() * msgs->size() * bytes);
+            });
+        }
+    }
+}
+
+/// ### end of benchmarks ###///
+
+/**
+ * the main func of the benchmark
+ * @param argc the number of args
+ * @param argv the aray of args
+ * @return success
+ */
+int main(int argc, char* argv[])
+{
+    BenchmarkSuite suite;
+    if (!suite.parseArgs(&argc, argv) || argc > 2)
+    {
+        std::cerr << "Usage: DetectorBenchmark [SpamDetector path] [--filter=<text>] [--min-time=<seconds>] "
+                     "[--format=console|json|csv]" << std::endl;
+        return 1;
+    }
+    std::string detector = argc == 2 ? argv[1] : "";
+    if (detector.empty())
+    {
+        std::cerr << "no SpamDetector path, only the in process benchmarks run" << std::endl;
+    }
+    std::filesystem::path dir = std::filesystem::temp_directory_path() /
+                                ("spam_benchmark_" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+    for (int phrases : {1000, 100000})
+    {
+        addDatabaseBenchmarks(&suite, phrases, detector, dir);
+    }
+    suite.run();
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*******************************************include********************************************************************/
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "HashMap.hpp"
+
+/***********************************************define*****************************************************************/
+// benchmark of the hash functions of the HashMap on a phrase corpus. for every hash function it prints how the phrases
+// spread over the buckets of a table at 0.75 load (longest chain, average chain of a non empty bucket, empty buckets),
+// the hashing throughput, and the time to build and query a HashMap<std::string, int> with it.
+// the corpus is the phrases of a "phrase,number" database given as the first argument, or synthetic phrases.
+// build: g++ -std=c++17 -O2 -I. benchmarks/HashBenchmark.cpp -o HashBenchmark
+// run:   ./HashBenchmark [database path]
+
+#define SYNTHETIC_PHRASES 500000
+#define LOAD 0.75
+#define ROUNDS 10
+#define SEPARATE ','
+
+/*************************************************methods**************************************************************/
+
+/**
+ * read the phrases of a database, or make synthetic ones
+ * @param argc the number of args
+ * @param argv the aray of args
+ * @return the phrases
+ */
+std::vector<std::string> loadCorpus(int argc, char* argv[])
+{
+    std::vector<std::string> phrases;
+    if (argc > 1)
+    {
+        std::ifstream database(argv[1]);
+        std::string line;
+        while (getline(database, line))
+        {
+            phrases.push_back(line.substr(0, line.find(SEPARATE)));
+        }
+        return phrases;
+    }
+    for (int i = 0; i < SYNTHETIC_PHRASES; i++)
+    {
+        phrases.push_back("buy " + std::to_string(i % 1000) + " cheap pills " + std::to_string(i / 1000));
+    }
+    return phrases;
+}
+
+/**
+ * print how the hashes spread over the buckets of a table that holds them at LOAD
+ * @param name the name of the hash function
+ * @param hashes the bucket index of every phrase is hashes[i] & (capacity - 1)
+ */
+void printSpread(const std::string& name, const std::vector<size_t>& hashes)
+{
+    size_t capacity = 1;
+    while ((double) hashes.size() / capacity > LOAD)
+    {
+        capacity *= 2;
+    }
+    std::vector<int> chains(capacity, 0);
+    for (size_t hash : hashes)
+    {
+        chains[hash & (capacity - 1)]++;
+    }
+    size_t empty = (size_t) std::count(chains.begin(), chains.end(), 0);
+    int longest = *std::max_element(chains.begin(), chains.end());
+    std::cout << name << ": buckets " << capacity << ", longest chain " << longest << ", average chain "
+              << (double) hashes.size() / (double) (capacity - empty) << ", empty buckets "
+              << 100.0 * (double) empty / (double) capacity << "%" << std::endl;
+}
+
+/**
+ * measure a hash function on the corpus
+ * @param name the name of the hash function
+ * @param phrases the corpus
+ * @param hasher the hash function, as the HashMap applies it (mixing included)
+ */
+template <class Hasher>
+void measureHash(const std::string& name, const std::vector<std::string>& phrases, Hasher hasher)
+{
+    std::vector<size_t> hashes;
+    size_t bytes = 0;
+    for (const auto& phrase : phrases)
+    {
+        hashes.push_back(hasher(phrase));
+        bytes += phrase.size();
+    }
+    printSpread(name, hashes);
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        for (const auto& phrase : phrases)
+        {
+            checksum += hasher(phrase);
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << (double) bytes * ROUNDS / elapsed.count() / 1e6 << " MB/sec hashed (checksum "
+              << checksum % 1000 << ")" << std::endl;
+}
+
+/**
+ * measure building and querying a HashMap on the corpus
+ * @param name the name of the configuration
+ * @param phrases the corpus
+ */
+template <class Map>
+void measureMap(const std::string& name, const std::vector<std::string>& phrases)
+{
+    auto start = std::chrono::steady_clock::now();
+    Map map;
+    for (size_t i = 0; i < phrases.size(); i++)
+    {
+        map.insert(phrases[i], (int) i);
+    }
+    std::chrono::duration<double> built = std::chrono::steady_clock::now() - start;
+    long long checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        for (const auto& phrase : phrases)
+        {
+            checksum += map.at(phrase);
+        }
+    }
+    std::chrono::duration<double> queried = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": build " << built.count() * 1e3 << " ms, "
+              << (double) phrases.size() * ROUNDS / queried.count() / 1e6 << "M lookups/sec (checksum "
+              << checksum << ")" << std::endl;
+}
+
+/**
+ * the main func of the benchmark
+ * @param argc the number of args
+ * @param argv the aray of args
+ * @return success
+ */
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> phrases = loadCorpus(argc, argv);
+    std::sort(phrases.begin(), phrases.end());
+    phrases.erase(std::unique(phrases.begin(), phrases.end()), phrases.end());
+    std::cout << phrases.size() << " distinct phrases" << std::endl;
+
+    measureHash("std::hash, not mixed", phrases, std::hash<std::string>());
+    measureHash("HashMapHash, mixed", phrases,
+                [](const std::string& phrase) { return hashIndexMix(HashMapHash<std::string>()(phrase)); });
+    measureHash("FastStringHash", phrases, FastStringHash());
+
+    std::vector<std::string> numbers;
+    for (size_t i = 0; i < phrases.size(); i++)
+    {
+        numbers.push_back(std::to_string(i * 1024));
+    }
+    std::vector<size_t> strided, stridedMixed;
+    for (size_t i = 0; i < phrases.size(); i++)
+    {
+        strided.push_back(std::hash<size_t>()(i * 1024));
+        stridedMixed.push_back(hashIndexMix(std::hash<size_t>()(i * 1024)));
+    }
+    printSpread("std::hash<size_t> of multiples of 1024, not mixed", strided);
+    printSpread("std::hash<size_t> of multiples of 1024, mixed", stridedMixed);
+
+    measureMap<HashMap<std::string, int>>("HashMap, HashMapHash", phrases);
+    measureMap<HashMap<std::string, int, ChainedBuckets, FastStringHash>>("HashMap, FastStringHash", phrases);
+    measureMap<HashMap<std::string, int, OpenAddressing, FastStringHash>>("HashMap, OpenAddressing, FastStringHash",
+                                                                         phrases);
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*******************************************include********************************************************************/
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "HashMap.hpp"
+
+/***********************************************define*****************************************************************/
+// micro benchmark of the lookups of HashMap<std::string, int>, prints the lookups per second of containsKey and at
+// for keys that are in the map (hits) and keys that are not (misses).
+// build: g++ -std=c++17 -O2 -I. benchmarks/LookupBenchmark.cpp -o LookupBenchmark
+
+#define KEYS_NUM 100000
+#define ROUNDS 20
+
+/*************************************************methods**************************************************************/
+
+/**
+ * make a vector of phrase like keys
+ * @param prefix the prefix of every key
+ * @param amount the number of keys
+ * @return the keys
+ */
+std::vector<std::string> makeKeys(const std::string& prefix, int amount)
+{
+    std::vector<std::string> keys;
+    keys.reserve((size_t) amount);
+    for (int i = 0; i < amount; i++)
+    {
+        keys.push_back(prefix + " phrase number " + std::to_string(i));
+    }
+    return keys;
+}
+
+/**
+ * run a lookup function over all the keys ROUNDS times and print the lookups per second
+ * @param name the name of the measurement
+ * @param keys the keys we look for
+ * @param lookup the lookup, returns a number that is summed so the lookup is not optimized away
+ */
+template <class Lookup>
+void measure(const std::string& name, const std::vector<std::string>& keys, Lookup lookup)
+{
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        for (const auto& key : keys)
+        {
+            checksum += lookup(key);
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double perSecond = (double) keys.size() * ROUNDS / elapsed.count();
+    std::cout << name << ": " << (long long) perSecond << " lookups/sec (checksum " << checksum << ")"
+              << std::endl;
+}
+
+/**
+ * the main func of the benchmark
+ * @return success
+ */
+int main()
+{
+    std::vector<std::string> present = makeKeys("present", KEYS_NUM);
+    std::vector<std::string> absent = makeKeys("absent", KEYS_NUM);
+    HashMap<std::string, int> map;
+    for (int i = 0; i < KEYS_NUM; i++)
+    {
+        map.insert(present[i], i);
+    }
+    measure("containsKey hit", present, [&map](const std::string& key) { return map.containsKey(key); });
+    measure("containsKey miss", absent, [&map](const std::string& key) { return map.containsKey(key); });
+    measure("at hit", present, [&map](const std::string& key) { return map.at(key); });
+    return 0;
+}